@@ -424,6 +424,233 @@ TreeNode* deserialize(string data) {
     return dfs();
 }
 
+// ========== CENTROID DECOMPOSITION ==========
+
+// Centroid decomposition over an adjacency-array (CSR) tree of n nodes.
+// Every node stores its distance to each of its O(log n) centroid ancestors,
+// so distance / nearest-marked queries walk the centroid chain only.
+// Build is fully iterative (no recursion), safe for path-like trees.
+class CentroidDecomposition {
+private:
+    int n, LOG;
+    vector<int> adjStart, adj;      // CSR adjacency
+    vector<int> cpar, clevel;       // centroid tree parent / depth
+    vector<int> ancDist;            // ancDist[v * LOG + l] = dist(v, level-l centroid ancestor)
+    
+    // Sorted depth lists used for offline pair counting: one list per
+    // centroid component (sign +1) and one per branch of it (sign -1)
+    vector<int> depthPool;
+    vector<array<int, 3>> depthLists;   // {begin, end, sign}
+    
+    using MinHeap = priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>>;
+    vector<char> marked;
+    vector<MinHeap> best;           // {dist, node}, may hold stale or duplicate entries
+    vector<int> liveCount;          // marked nodes in each centroid's component
+    
+    // Drop unmarked and duplicate entries; entries pop in sorted order, so
+    // duplicates (from re-marking a node) end up adjacent
+    void compact(int c) {
+        vector<pair<int, int>> live;
+        for (MinHeap& heap = best[c]; !heap.empty(); heap.pop()) {
+            if (marked[heap.top().second]) live.push_back(heap.top());
+        }
+        live.erase(unique(live.begin(), live.end()), live.end());
+        best[c] = MinHeap(greater<pair<int, int>>(), move(live));
+    }
+    
+    void build() {
+        vector<char> removed(n, 0);
+        vector<int> sz(n), par(n), order;
+        order.reserve(n);
+        
+        vector<array<int, 3>> st = {{0, -1, 0}};   // {start, parent centroid, level}
+        while (!st.empty()) {
+            auto [s, p, lvl] = st.back();
+            st.pop_back();
+            
+            // BFS over the current component, then subtree sizes bottom-up
+            order.clear();
+            order.push_back(s);
+            par[s] = -1;
+            for (size_t i = 0; i < order.size(); i++) {
+                int u = order[i];
+                sz[u] = 1;
+                for (int e = adjStart[u]; e < adjStart[u + 1]; e++) {
+                    int v = adj[e];
+                    if (v != par[u] && !removed[v]) {
+                        par[v] = u;
+                        order.push_back(v);
+                    }
+                }
+            }
+            for (int i = (int)order.size() - 1; i > 0; i--) {
+                sz[par[order[i]]] += sz[order[i]];
+            }
+            
+            // Walk towards the heavy child until no child exceeds half
+            int total = order.size(), c = s;
+            while (true) {
+                int heavy = -1;
+                for (int e = adjStart[c]; e < adjStart[c + 1]; e++) {
+                    int v = adj[e];
+                    if (v != par[c] && !removed[v] && 2 * sz[v] > total) {
+                        heavy = v;
+                        break;
+                    }
+                }
+                if (heavy == -1) break;
+                c = heavy;
+            }
+            
+            cpar[c] = p;
+            clevel[c] = lvl;
+            ancDist[c * LOG + lvl] = 0;
+            
+            // BFS each branch hanging off c; BFS order keeps depths sorted
+            int compBegin = depthPool.size();
+            depthPool.push_back(0);
+            for (int e = adjStart[c]; e < adjStart[c + 1]; e++) {
+                int nb = adj[e];
+                if (removed[nb]) continue;
+                
+                int branchBegin = depthPool.size();
+                order.clear();
+                order.push_back(nb);
+                par[nb] = c;
+                ancDist[nb * LOG + lvl] = 1;
+                for (size_t i = 0; i < order.size(); i++) {
+                    int u = order[i];
+                    int d = ancDist[u * LOG + lvl];
+                    depthPool.push_back(d);
+                    for (int f = adjStart[u]; f < adjStart[u + 1]; f++) {
+                        int v = adj[f];
+                        if (v != par[u] && !removed[v]) {
+                            par[v] = u;
+                            ancDist[v * LOG + lvl] = d + 1;
+                            order.push_back(v);
+                        }
+                    }
+                }
+                depthLists.push_back({branchBegin, (int)depthPool.size(), -1});
+            }
+            
+            // Whole component = centroid + all branches, sorted
+            int compEnd = depthPool.size();
+            int listBegin = compEnd;
+            for (int i = compBegin; i < compEnd; i++) {
+                depthPool.push_back(depthPool[i]);
+            }
+            sort(depthPool.begin() + listBegin, depthPool.end());
+            depthLists.push_back({listBegin, (int)depthPool.size(), +1});
+            
+            removed[c] = 1;
+            for (int e = adjStart[c]; e < adjStart[c + 1]; e++) {
+                if (!removed[adj[e]]) st.push_back({adj[e], c, lvl + 1});
+            }
+        }
+    }
+    
+public:
+    // edges: n-1 undirected edges of a tree on nodes 0..n-1
+    CentroidDecomposition(int n, const vector<pair<int, int>>& edges) : n(n) {
+        LOG = 1;
+        while ((1 << LOG) <= n) LOG++;
+        
+        adjStart.assign(n + 1, 0);
+        for (auto& [u, v] : edges) {
+            adjStart[u + 1]++;
+            adjStart[v + 1]++;
+        }
+        for (int i = 0; i < n; i++) adjStart[i + 1] += adjStart[i];
+        adj.resize(2 * edges.size());
+        vector<int> pos(adjStart.begin(), adjStart.end() - 1);
+        for (auto& [u, v] : edges) {
+            adj[pos[u]++] = v;
+            adj[pos[v]++] = u;
+        }
+        
+        cpar.assign(n, -1);
+        clevel.assign(n, 0);
+        ancDist.assign((size_t)n * LOG, 0);
+        marked.assign(n, 0);
+        best.resize(n);
+        liveCount.assign(n, 0);
+        if (n > 0) build();
+    }
+    
+    int centroidParent(int v) const { return cpar[v]; }
+    int centroidLevel(int v) const { return clevel[v]; }
+    
+    // Distance via the lowest common centroid ancestor - O(log n)
+    int distance(int u, int v) const {
+        int a = u, b = v;
+        while (clevel[a] > clevel[b]) a = cpar[a];
+        while (clevel[b] > clevel[a]) b = cpar[b];
+        while (a != b) {
+            a = cpar[a];
+            b = cpar[b];
+        }
+        return ancDist[u * LOG + clevel[a]] + ancDist[v * LOG + clevel[a]];
+    }
+    
+    // O(log n * log n) - push v into the heap of every centroid ancestor
+    void mark(int v) {
+        if (marked[v]) return;
+        marked[v] = 1;
+        for (int c = v; c != -1; c = cpar[c]) {
+            best[c].push({ancDist[v * LOG + clevel[c]], v});
+            liveCount[c]++;
+        }
+    }
+    
+    // Amortized O(log n * log n) - stale entries are discarded lazily by
+    // nearestMarked, and a heap is compacted once they outnumber live ones,
+    // so heap sizes stay O(marked) even when queries are rare
+    void unmark(int v) {
+        if (!marked[v]) return;
+        marked[v] = 0;
+        for (int c = v; c != -1; c = cpar[c]) {
+            liveCount[c]--;
+            if ((int)best[c].size() > 2 * liveCount[c] + 1) compact(c);
+        }
+    }
+    
+    // Returns {distance, node} of the closest marked node, {-1, -1} if none
+    pair<int, int> nearestMarked(int v) {
+        pair<int, int> res = {INT_MAX, -1};
+        for (int c = v; c != -1; c = cpar[c]) {
+            auto& heap = best[c];
+            while (!heap.empty() && !marked[heap.top().second]) heap.pop();
+            if (heap.empty()) continue;
+            
+            int d = ancDist[v * LOG + clevel[c]] + heap.top().first;
+            if (d < res.first) res = {d, heap.top().second};
+        }
+        if (res.second == -1) return {-1, -1};
+        return res;
+    }
+    
+    // Offline: number of unordered pairs (u, v), u != v, with dist(u, v) <= k.
+    // Each pair is counted at the first centroid separating it - O(n log n) per k
+    long long countPairsWithinDistance(int k) const {
+        long long total = 0;
+        for (auto& [b, e, sign] : depthLists) {
+            long long cnt = 0;
+            int i = b, j = e - 1;
+            while (i < j) {
+                if (depthPool[i] + depthPool[j] <= k) {
+                    cnt += j - i;
+                    i++;
+                } else {
+                    j--;
+                }
+            }
+            total += sign * cnt;
+        }
+        return total;
+    }
+};
+
 // ========== UTILITY FUNCTIONS ==========
 
 void printTree(TreeNode* root, int level = 0) {
@@ -485,5 +712,18 @@ int main() {
     cout << "\n=== Tree Structure ===" << endl;
     printTree(root);
     
+    cout << "\n=== Centroid Decomposition ===" << endl;
+    // Edges: 0-1, 0-2, 1-3, 1-4, 2-5, 5-6
+    CentroidDecomposition cd(7, {{0, 1}, {0, 2}, {1, 3}, {1, 4}, {2, 5}, {5, 6}});
+    cout << "Distance(3, 6): " << cd.distance(3, 6) << endl;
+    cout << "Pairs within distance 2: " << cd.countPairsWithinDistance(2) << endl;
+    cd.mark(6);
+    cd.mark(4);
+    auto [d, node] = cd.nearestMarked(0);
+    cout << "Nearest marked to 0: node " << node << " at distance " << d << endl;
+    cd.unmark(4);
+    tie(d, node) = cd.nearestMarked(3);
+    cout << "After unmarking 4, nearest marked to 3: node " << node << " at distance " << d << endl;
+    
     return 0;
 }
@@ -468,6 +468,185 @@ void floydWarshall(vector<vector<int>>& dist) {
     }
 }
 
+// ========== DP OPTIMIZATION (CONVEX HULL TRICK) ==========
+
+// Transitions of the form dp[i] = min over j of (m_j * x_i + b_j) are
+// "minimum over lines at x". Both structures below answer that, turning
+// the O(n^2) scan over j into O(log) or amortized O(1) per state.
+
+// Li Chao tree over the integer range [lo, hi], nodes created on demand,
+// so the range can be huge (e.g. [-1e9, 1e9]) with O(q log range) memory.
+// C = coordinate type, V = value type. Keeps the minimum.
+template <typename C, typename V>
+class LiChaoTree {
+private:
+    struct Line {
+        V m, b;
+        V eval(C x) const { return m * V(x) + b; }
+    };
+    
+    struct Node {
+        Line line;
+        int left = -1, right = -1;
+    };
+    
+    vector<Node> nodes;
+    C lo, hi;
+    
+public:
+    LiChaoTree(C lo, C hi) : lo(lo), hi(hi) {}
+    
+    // Adds y = m * x + b - O(log(hi - lo))
+    void addLine(V m, V b) {
+        Line line = {m, b};
+        if (nodes.empty()) {
+            nodes.push_back({line});
+            return;
+        }
+        
+        int node = 0;
+        C l = lo, r = hi;
+        while (true) {
+            C mid = l + (r - l) / 2;
+            Line& cur = nodes[node].line;
+            bool leftBetter = line.eval(l) < cur.eval(l);
+            bool midBetter = line.eval(mid) < cur.eval(mid);
+            if (midBetter) swap(cur, line);
+            if (l == r) return;
+            
+            // The loser can only win on one side of mid
+            bool goLeft = leftBetter != midBetter;
+            int next = goLeft ? nodes[node].left : nodes[node].right;
+            if (next == -1) {
+                nodes.push_back({line});
+                if (goLeft) nodes[node].left = nodes.size() - 1;
+                else nodes[node].right = nodes.size() - 1;
+                return;
+            }
+            node = next;
+            if (goLeft) r = mid;
+            else l = mid + 1;
+        }
+    }
+    
+    // min over lines at x, numeric_limits<V>::max() if empty - O(log(hi - lo))
+    V query(C x) const {
+        V res = numeric_limits<V>::max();
+        int node = nodes.empty() ? -1 : 0;
+        C l = lo, r = hi;
+        while (node != -1) {
+            res = min(res, nodes[node].line.eval(x));
+            C mid = l + (r - l) / 2;
+            if (x <= mid) {
+                node = nodes[node].left;
+                r = mid;
+            } else {
+                node = nodes[node].right;
+                l = mid + 1;
+            }
+        }
+        return res;
+    }
+};
+
+// Convex hull trick for minimum when lines arrive with strictly decreasing
+// slopes. The lower envelope lives in a deque; queries are O(log n) by
+// binary search, or amortized O(1) when x never decreases.
+// C = coordinate type, V = value type, as in LiChaoTree.
+template <typename C, typename V>
+class MonotoneCHT {
+private:
+    // Operands are widened before subtracting, so intersection comparisons are
+    // exact for 64-bit integers while |m|, |b| <= 6.5e18 (products < 2^127)
+    using Wide = conditional_t<is_integral_v<V>, __int128, V>;
+    
+    struct Line {
+        V m, b;
+        V eval(C x) const { return m * V(x) + b; }
+    };
+    
+    deque<Line> hull;
+    
+    // Line b is useless if a and c meet at or below it
+    static bool useless(const Line& a, const Line& b, const Line& c) {
+        return (Wide(c.b) - Wide(a.b)) * (Wide(a.m) - Wide(b.m))
+            <= (Wide(b.b) - Wide(a.b)) * (Wide(a.m) - Wide(c.m));
+    }
+    
+public:
+    // Slopes must be strictly decreasing across calls
+    void addLine(V m, V b) {
+        Line line = {m, b};
+        while (hull.size() >= 2 && useless(hull[hull.size() - 2], hull.back(), line)) {
+            hull.pop_back();
+        }
+        hull.push_back(line);
+    }
+    
+    // Arbitrary x, numeric_limits<V>::max() if empty - O(log n)
+    V query(C x) const {
+        if (hull.empty()) return numeric_limits<V>::max();
+        int lo = 0, hi = hull.size() - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (hull[mid].eval(x) >= hull[mid + 1].eval(x)) lo = mid + 1;
+            else hi = mid;
+        }
+        return hull[lo].eval(x);
+    }
+    
+    // Non-decreasing x across calls, numeric_limits<V>::max() if empty - amortized O(1)
+    V queryMonotone(C x) {
+        if (hull.empty()) return numeric_limits<V>::max();
+        while (hull.size() >= 2 && hull[0].eval(x) >= hull[1].eval(x)) {
+            hull.pop_front();
+        }
+        return hull.front().eval(x);
+    }
+};
+
+// Frog jumps from stone j to i > j for (h[i] - h[j])^2 + C; min cost 0 -> n-1.
+// dp[i] = h[i]^2 + C + min over j of (-2 h[j]) * h[i] + (dp[j] + h[j]^2)
+long long minJumpCostNaive(vector<long long>& h, long long C) {
+    int n = h.size();
+    vector<long long> dp(n, LLONG_MAX);
+    dp[0] = 0;
+    for (int i = 1; i < n; i++) {
+        for (int j = 0; j < i; j++) {
+            dp[i] = min(dp[i], dp[j] + (h[i] - h[j]) * (h[i] - h[j]) + C);
+        }
+    }
+    return dp[n - 1];
+}
+
+// Strictly increasing heights: slopes -2h[j] decrease, queries increase - O(n)
+long long minJumpCostCHT(vector<long long>& h, long long C) {
+    int n = h.size();
+    vector<long long> dp(n);
+    MonotoneCHT<long long, long long> cht;
+    dp[0] = 0;
+    cht.addLine(-2 * h[0], h[0] * h[0]);
+    for (int i = 1; i < n; i++) {
+        dp[i] = cht.queryMonotone(h[i]) + h[i] * h[i] + C;
+        cht.addLine(-2 * h[i], dp[i] + h[i] * h[i]);
+    }
+    return dp[n - 1];
+}
+
+// Any heights in [0, maxH] - O(n log maxH)
+long long minJumpCostLiChao(vector<long long>& h, long long C, long long maxH) {
+    int n = h.size();
+    vector<long long> dp(n);
+    LiChaoTree<long long, long long> tree(0, maxH);
+    dp[0] = 0;
+    tree.addLine(-2 * h[0], h[0] * h[0]);
+    for (int i = 1; i < n; i++) {
+        dp[i] = tree.query(h[i]) + h[i] * h[i] + C;
+        tree.addLine(-2 * h[i], dp[i] + h[i] * h[i]);
+    }
+    return dp[n - 1];
+}
+
 // ========== UTILITY FUNCTIONS ==========
 
 void printDP1D(vector<int>& dp) {
@@ -518,5 +697,12 @@ int main() {
     cout << "LCS (abc, ac): " << longestCommonSubsequence("abc", "ac") << endl;
     cout << "Palindromic substrings (ababa): " << countSubstrings("ababa") << endl;
     
+    // Convex Hull Trick
+    cout << "\n=== Convex Hull Trick ===" << endl;
+    vector<long long> heights = {1, 2, 3, 4, 5};
+    cout << "Min jump cost (naive O(n^2)): " << minJumpCostNaive(heights, 6) << endl;
+    cout << "Min jump cost (monotone CHT): " << minJumpCostCHT(heights, 6) << endl;
+    cout << "Min jump cost (Li Chao tree): " << minJumpCostLiChao(heights, 6, 1000000) << endl;
+    
     return 0;
 }
@@ -79,34 +79,472 @@ vector<int> getPrimes(int n) {
     return primes;
 }
 
-// Segmented sieve - find primes in range [L, R]
-vector<long long> segmentedSieve(long long L, long long R) {
-    // Generate primes up to sqrt(R)
-    long long limit = sqrt(R);
-    vector<bool> isPrime = sieve(limit);
-    vector<long long> primes = getPrimes(limit);
+// ============================================================================
+// SEGMENTED BIT-PACKED SIEVE
+// ============================================================================
+
+// Sieves [lo, hi] in L1-sized segments, one bit per odd number, so memory
+// is O(sqrt(hi)) for the base primes plus one 32 KB segment regardless of
+// the range. Counting uses popcount over whole words.
+class PrimeSieve {
+public:
+    static constexpr int SEGMENT_BYTES = 1 << 15;
+    static constexpr int SEGMENT_BITS = SEGMENT_BYTES * 8;     // odd numbers per segment
+    
+private:
+    // Multiples of 3, 5, 7, 11, 13 repeat every 15015 odd numbers; copying a
+    // precomputed pattern replaces their (densest) crossing-off loops
+    static constexpr int WHEEL_PERIOD = 3 * 5 * 7 * 11 * 13;
+    static constexpr int WHEEL_PRIMES = 5;
+    
+    vector<int> basePrimes;     // odd primes up to sqrt(limit)
+    vector<uint64_t> wheel;     // 64 periods so every word boundary repeats
+    long long limit;
+    
+    // Next odd multiple of each base prime still to be crossed off
+    vector<long long> firstMultiples(long long low) const {
+        vector<long long> next(basePrimes.size());
+        for (size_t i = 0; i < basePrimes.size(); i++) {
+            long long p = basePrimes[i];
+            long long start = max(p * p, (low + p - 1) / p * p);
+            if (start % 2 == 0) start += p;
+            next[i] = start;
+        }
+        return next;
+    }
     
-    // Create array for range [L, R]
-    vector<bool> rangePrime(R - L + 1, true);
+    // Bit j of words <=> segLow + 2j is prime, for j < bits (segLow odd)
+    void fillSegment(long long segLow, int bits, vector<uint64_t>& words,
+                     vector<long long>& next) const {
+        int nWords = (bits + 63) / 64;
+        long long pos = (segLow / 2) % (64LL * WHEEL_PERIOD);
+        int wi = pos / 64, shift = pos % 64;
+        for (int w = 0; w < nWords; w++) {
+            words[w] = shift ? (wheel[wi] >> shift) | (wheel[wi + 1] << (64 - shift)) : wheel[wi];
+            if (++wi == WHEEL_PERIOD) wi = 0;
+        }
+        if (segLow <= 13) {
+            for (int p : {3, 5, 7, 11, 13}) {
+                if (p >= segLow && (p - segLow) / 2 < bits) words[(p - segLow) / 2 / 64] |= 1ULL << ((p - segLow) / 2 % 64);
+            }
+        }
+        if (bits % 64) words[nWords - 1] &= (1ULL << (bits % 64)) - 1;
+        if (segLow == 1) words[0] &= ~1ULL;     // 1 is not prime
+        
+        long long segHigh = segLow + 2LL * bits;
+        for (size_t i = WHEEL_PRIMES; i < basePrimes.size(); i++) {
+            long long p = basePrimes[i];
+            if (p * p >= segHigh) break;
+            long long j = (next[i] - segLow) / 2;
+            for (; j < bits; j += p) words[j >> 6] &= ~(1ULL << (j & 63));
+            next[i] = segLow + 2 * j;
+        }
+    }
     
-    for (long long p : primes) {
-        long long start = max(p * p, (L + p - 1) / p * p);
+public:
+    // Supports ranges up to `limit`
+    PrimeSieve(long long limit) : limit(limit) {
+        int root = max<long long>(sqrtl(limit) + 1, 13);
+        vector<char> composite(root + 1, 0);
+        for (int i = 3; i <= root; i += 2) {
+            if (composite[i]) continue;
+            basePrimes.push_back(i);
+            for (long long j = (long long)i * i; j <= root; j += 2 * i) composite[j] = 1;
+        }
         
-        for (long long j = start; j <= R; j += p) {
-            rangePrime[j - L] = false;
+        // Bit k <=> odd number 2k + 1 has no factor among the wheel primes
+        wheel.assign(WHEEL_PERIOD + 1, 0);
+        for (int k = 0; k < 64 * WHEEL_PERIOD; k++) {
+            int v = (2 * k + 1) % WHEEL_PERIOD;
+            if (v % 3 && v % 5 && v % 7 && v % 11 && v % 13) wheel[k / 64] |= 1ULL << (k % 64);
         }
+        wheel[WHEEL_PERIOD] = wheel[0];
     }
     
-    vector<long long> result;
-    for (long long i = L; i <= R; i++) {
-        if (rangePrime[i - L]) {
-            result.push_back(i);
+    // Calls onSegment(segLow, words, bits) for each sieved segment of [lo, hi]
+    template <typename SegmentFn>
+    void sieveRange(long long lo, long long hi, SegmentFn onSegment) const {
+        hi = min(hi, limit);
+        long long low = max(lo, 1LL) | 1;       // first odd number >= lo
+        if (low > hi) return;
+        
+        vector<uint64_t> words(SEGMENT_BITS / 64);
+        vector<long long> next = firstMultiples(low);
+        for (long long segLow = low; segLow <= hi; segLow += 2LL * SEGMENT_BITS) {
+            int bits = min<long long>(SEGMENT_BITS, (hi - segLow) / 2 + 1);
+            fillSegment(segLow, bits, words, next);
+            onSegment(segLow, words.data(), bits);
         }
     }
     
+    // Number of primes in [lo, hi]
+    long long count(long long lo, long long hi) const {
+        long long total = (lo <= 2 && 2 <= min(hi, limit)) ? 1 : 0;
+        sieveRange(lo, hi, [&](long long, const uint64_t* words, int bits) {
+            for (int w = 0; w < (bits + 63) / 64; w++) total += __builtin_popcountll(words[w]);
+        });
+        return total;
+    }
+    
+    // Calls f(p) for every prime p in [lo, hi] in increasing order
+    template <typename PrimeFn>
+    void forEachPrime(long long lo, long long hi, PrimeFn f) const {
+        if (lo <= 2 && 2 <= min(hi, limit)) f(2LL);
+        sieveRange(lo, hi, [&](long long segLow, const uint64_t* words, int bits) {
+            for (int w = 0; w < (bits + 63) / 64; w++) {
+                for (uint64_t m = words[w]; m; m &= m - 1) {
+                    f(segLow + 2LL * (w * 64 + __builtin_ctzll(m)));
+                }
+            }
+        });
+    }
+    
+    // Pull-style iteration over the primes of [lo, hi], one segment at a time
+    class Iterator {
+    private:
+        const PrimeSieve& sieve;
+        long long hi, segLow;
+        vector<uint64_t> words;
+        vector<long long> multiples;
+        int bits = 0, word = 0;
+        uint64_t pending = 0;
+        bool emitTwo;
+        
+        bool loadSegment() {
+            if (segLow > hi) return false;
+            bits = min<long long>(SEGMENT_BITS, (hi - segLow) / 2 + 1);
+            sieve.fillSegment(segLow, bits, words, multiples);
+            word = 0;
+            pending = words[0];
+            return true;
+        }
+        
+    public:
+        Iterator(const PrimeSieve& sieve, long long lo, long long hi)
+            : sieve(sieve), hi(min(hi, sieve.limit)), words(SEGMENT_BITS / 64) {
+            emitTwo = lo <= 2 && 2 <= this->hi;
+            segLow = max(lo, 1LL) | 1;
+            multiples = sieve.firstMultiples(segLow);
+            if (!loadSegment()) segLow = LLONG_MAX;
+        }
+        
+        // Next prime, or -1 once the range is exhausted
+        long long next() {
+            if (emitTwo) {
+                emitTwo = false;
+                return 2;
+            }
+            while (segLow != LLONG_MAX) {
+                if (pending) {
+                    int bit = __builtin_ctzll(pending);
+                    pending &= pending - 1;
+                    return segLow + 2LL * (word * 64 + bit);
+                }
+                if (++word < (bits + 63) / 64) {
+                    pending = words[word];
+                    continue;
+                }
+                segLow += 2LL * SEGMENT_BITS;
+                if (!loadSegment()) segLow = LLONG_MAX;
+            }
+            return -1;
+        }
+    };
+    
+    Iterator primes(long long lo, long long hi) const {
+        return Iterator(*this, lo, hi);
+    }
+    
+    // Each worker sieves a contiguous block of this many segments per round
+    static constexpr int BLOCK_SEGMENTS = 32;
+    
+    // Number of primes in [lo, hi], striped across threads
+    long long countParallel(long long lo, long long hi, int threads) const {
+        hi = min(hi, limit);
+        if (lo > hi) return 0;
+        threads = max(threads, 1);
+        long long stripe = (hi - lo) / threads + 1;
+        vector<long long> counts(threads, 0);
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) {
+            long long from = lo + t * stripe, to = min(hi, from + stripe - 1);
+            if (from > to) break;
+            workers.emplace_back([&, t, from, to]() { counts[t] = count(from, to); });
+        }
+        for (thread& w : workers) w.join();
+        return accumulate(counts.begin(), counts.end(), 0LL);
+    }
+    
+    // Streams the primes of [lo, hi] to onChunk(const vector<long long>&) in
+    // increasing order. Each round the workers sieve adjacent blocks into their
+    // own buffers, so memory is bounded by threads * BLOCK_SEGMENTS segments.
+    template <typename ChunkFn>
+    void forEachPrimeChunk(long long lo, long long hi, int threads, ChunkFn onChunk) const {
+        hi = min(hi, limit);
+        threads = max(threads, 1);
+        const long long blockSpan = 2LL * SEGMENT_BITS * BLOCK_SEGMENTS;
+        vector<vector<long long>> chunks(threads);
+        
+        for (long long roundLow = lo; roundLow <= hi; ) {
+            vector<thread> workers;
+            int used = 0;
+            for (; used < threads && roundLow <= hi; used++) {
+                long long from = roundLow, to = min(hi, roundLow + blockSpan - 1);
+                roundLow = to + 1;
+                chunks[used].clear();
+                workers.emplace_back([this, &chunks, used, from, to]() {
+                    forEachPrime(from, to, [&](long long p) { chunks[used].push_back(p); });
+                });
+            }
+            for (thread& w : workers) w.join();
+            for (int t = 0; t < used; t++) {
+                if (!chunks[t].empty()) onChunk(chunks[t]);
+            }
+        }
+    }
+};
+
+// Segmented sieve - streams the primes in [L, R] to onChunk in increasing
+// order using `threads` workers; memory does not grow with R - L
+template <typename ChunkFn>
+void segmentedSieve(long long L, long long R, ChunkFn onChunk,
+                    int threads = max(1u, thread::hardware_concurrency())) {
+    if (L > R) return;
+    PrimeSieve(R).forEachPrimeChunk(L, R, threads, onChunk);
+}
+
+// Segmented sieve - find primes in range [L, R]
+vector<long long> segmentedSieve(long long L, long long R) {
+    vector<long long> result;
+    segmentedSieve(L, R, [&](const vector<long long>& chunk) {
+        result.insert(result.end(), chunk.begin(), chunk.end());
+    });
     return result;
 }
 
+// ============================================================================
+// LINEAR SIEVE
+// ============================================================================
+
+// Euler's linear sieve: every composite is struck exactly once by its smallest
+// prime factor, which lets phi, mu and the divisor count be filled in the same
+// pass. Tables use the narrowest type that fits n <= 2^31 - 1.
+class LinearSieve {
+private:
+    int n;
+    vector<int> primes;
+    vector<int32_t> spf;        // smallest prime factor, spf[1] = 1
+    vector<int32_t> phi;
+    vector<int8_t> mu;
+    vector<uint16_t> divisors;  // d(n) <= 1600 for n < 2^31
+    
+public:
+    // n may be INT_MAX: sizes and the outer index are computed in long long
+    LinearSieve(int n)
+        : n(n), spf(n + 1LL, 0), phi(n + 1LL, 0), mu(n + 1LL, 0), divisors(n + 1LL, 0) {
+        vector<uint8_t> spfExp(n + 1LL, 0);     // exponent of spf in i, only needed for d(i)
+        if (n >= 1) spf[1] = phi[1] = mu[1] = divisors[1] = 1;
+        for (long long i = 2; i <= n; i++) {
+            if (spf[i] == 0) {
+                spf[i] = i;
+                primes.push_back(i);
+                phi[i] = i - 1;
+                mu[i] = -1;
+                divisors[i] = 2;
+                spfExp[i] = 1;
+            }
+            for (int p : primes) {
+                long long ip = i * p;
+                if (p > spf[i] || ip > n) break;
+                spf[ip] = p;
+                if (p == spf[i]) {
+                    phi[ip] = phi[i] * p;
+                    mu[ip] = 0;
+                    spfExp[ip] = spfExp[i] + 1;
+                    divisors[ip] = divisors[i] / (spfExp[i] + 1) * (spfExp[ip] + 1);
+                } else {
+                    phi[ip] = phi[i] * (p - 1);
+                    mu[ip] = -mu[i];
+                    spfExp[ip] = 1;
+                    divisors[ip] = divisors[i] * 2;
+                }
+            }
+        }
+    }
+    
+    int size() const { return n; }
+    const vector<int>& getPrimes() const { return primes; }
+    bool isPrime(int x) const { return x >= 2 && spf[x] == x; }
+    int smallestPrimeFactor(int x) const { return spf[x]; }
+    int totient(int x) const { return phi[x]; }
+    int mobius(int x) const { return mu[x]; }
+    int divisorCount(int x) const { return divisors[x]; }
+    
+    // Prime factorization as sorted (prime, exponent) pairs in O(log x)
+    vector<pair<int, int>> factorize(int x) const {
+        vector<pair<int, int>> factors;
+        while (x > 1) {
+            int p = spf[x], e = 0;
+            do {
+                x /= p;
+                e++;
+            } while (spf[x] == p);
+            factors.push_back({p, e});
+        }
+        return factors;
+    }
+};
+
+// ============================================================================
+// SUB-LINEAR PRIME COUNTING
+// ============================================================================
+
+// floor(sqrt(x)) without floating-point rounding errors
+long long isqrt(long long x) {
+    long long r = sqrtl(x);
+    while (r * r > x) r--;
+    while ((r + 1) * (r + 1) <= x) r++;
+    return r;
+}
+
+// Lucy_Hedgehog's DP over the O(sqrt x) distinct values v = floor(x / i).
+// Starting from S(v) = g(2) + ... + g(v), sieving with each prime p <= sqrt(x)
+// leaves S(v) = sum of g(p) over primes p <= v, for any completely
+// multiplicative g. O(x^(3/4) / log x) time and O(sqrt x) memory.
+template <typename T>
+class LucySieve {
+private:
+    long long x, root;
+    vector<T> small, large;     // small[v] = S(v) for v <= root, large[i] = S(x / i)
+    
+public:
+    // prefix(v) = g(2) + ... + g(v), weight(p) = g(p)
+    template <typename PrefixFn, typename WeightFn>
+    LucySieve(long long x, PrefixFn prefix, WeightFn weight,
+              int threads = max(1u, thread::hardware_concurrency()))
+        : x(x), root(isqrt(x)), small(root + 1), large(root + 1) {
+        for (long long v = 1; v <= root; v++) small[v] = prefix(v);
+        for (long long i = 1; i <= root; i++) large[i] = prefix(x / i);
+        
+        vector<T> scratch(root + 1);
+        for (long long p = 2; p <= root; p++) {
+            if (small[p] == small[p - 1]) continue;     // p is composite
+            T gp = weight(p), below = small[p - 1];
+            long long p2 = p * p;
+            long long largeEnd = min(root, x / p2);     // large[i] needs x / i >= p^2
+            
+            // Every update reads only values from before this prime's step
+            auto largeUpdate = [&](long long i) {
+                long long ip = i * p;
+                T other = ip <= root ? large[ip] : small[x / ip];
+                return large[i] - gp * (other - below);
+            };
+            if (threads == 1 || largeEnd < (1 << 15)) {
+                // Ascending i reads large[i * p] before it is overwritten
+                for (long long i = 1; i <= largeEnd; i++) large[i] = largeUpdate(i);
+            } else {
+                vector<thread> workers;
+                long long chunk = (largeEnd + threads - 1) / threads;
+                for (int t = 0; t < threads; t++) {
+                    long long from = 1 + t * chunk, to = min(largeEnd, from + chunk - 1);
+                    workers.emplace_back([&, from, to]() {
+                        for (long long i = from; i <= to; i++) scratch[i] = largeUpdate(i);
+                    });
+                }
+                for (thread& w : workers) w.join();
+                copy(scratch.begin() + 1, scratch.begin() + largeEnd + 1, large.begin() + 1);
+            }
+            // Descending v reads small[v / p] before it is overwritten
+            for (long long v = root; v >= p2; v--) small[v] -= gp * (small[v / p] - below);
+        }
+    }
+    
+    // S(v) for v <= sqrt(x) or v = floor(x / i)
+    T operator()(long long v) const {
+        return v <= root ? small[v] : large[x / v];
+    }
+};
+
+// Number of primes <= x
+long long primeCount(long long x, int threads = max(1u, thread::hardware_concurrency())) {
+    if (x < 2) return 0;
+    LucySieve<long long> count(x, [](long long v) { return v - 1; },
+                               [](long long) { return 1LL; }, threads);
+    return count(x);
+}
+
+// Sum of primes <= x (exceeds 64 bits beyond x ~ 10^10)
+__int128 primeSum(long long x, int threads = max(1u, thread::hardware_concurrency())) {
+    if (x < 2) return 0;
+    LucySieve<__int128> sum(x, [](long long v) { return (__int128)v * (v + 1) / 2 - 1; },
+                            [](long long p) { return (__int128)p; }, threads);
+    return sum(x);
+}
+
+string int128ToString(__int128 v) {
+    if (v == 0) return "0";
+    bool negative = v < 0;
+    string s;
+    for (; v != 0; v /= 10) s += char('0' + (negative ? -(v % 10) : v % 10));
+    if (negative) s += '-';
+    return string(s.rbegin(), s.rend());
+}
+
+// Min_25's second phase: sum of a multiplicative f over [1, x], given
+// primeSums(v) = sum of f(p) over primes p <= v (e.g. built from LucySieve
+// tables, valid for v = floor(x / i)) and powerValue(p, e) = f(p^e). Counts
+// numbers by smallest prime factor; the top-level split by that factor is
+// spread across threads.
+template <typename T, typename PrimeSumFn, typename PowerFn>
+T multiplicativePrefixSum(long long x, PrimeSumFn primeSums, PowerFn powerValue,
+                          int threads = max(1u, thread::hardware_concurrency())) {
+    if (x < 1) return 0;
+    const vector<int> primes = getPrimes(isqrt(x));
+    
+    // Sum of f(m) over 2 <= m <= n whose prime factors are all >= primes[k]
+    function<T(long long, size_t)> rough = [&](long long n, size_t k) -> T {
+        long long below = k == 0 ? 1 : primes[k - 1];
+        if (n <= below) return 0;
+        T total = primeSums(n) - primeSums(below);
+        for (size_t j = k; j < primes.size() && (long long)primes[j] * primes[j] <= n; j++) {
+            long long p = primes[j];
+            long long pe = p;
+            for (int e = 1; pe * p <= n; e++, pe *= p) {
+                total += powerValue(p, e) * rough(n / pe, j + 1) + powerValue(p, e + 1);
+            }
+        }
+        return total;
+    };
+    
+    // Same loop as rough(x, 0), with the smallest prime factor split across threads
+    threads = max(1, threads);
+    vector<T> partial(threads, T(0));
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (size_t j = t; j < primes.size(); j += threads) {
+                long long p = primes[j];
+                long long pe = p;
+                for (int e = 1; pe * p <= x; e++, pe *= p) {
+                    partial[t] += powerValue(p, e) * rough(x / pe, j + 1) + powerValue(p, e + 1);
+                }
+            }
+        });
+    }
+    for (thread& w : workers) w.join();
+    
+    T total = 1 + (x >= 2 ? primeSums(x) : T(0));    // f(1) + primes
+    for (const T& part : partial) total += part;
+    return total;
+}
+
+// Dirichlet hyperbola method: sum of d(n) for n <= x in O(sqrt x)
+long long divisorSummatory(long long x) {
+    long long root = isqrt(x), total = 0;
+    for (long long i = 1; i <= root; i++) total += x / i;
+    return 2 * total - root * root;
+}
+
 // ============================================================================
 // GCD AND LCM
 // ============================================================================
@@ -155,14 +593,16 @@ long long lcm(int a, int b) {
 
 const int MOD = 1000000007;
 
-// Modular addition
+// Modular addition; a and b must already be reduced into [0, MOD)
 int add(int a, int b) {
-    return (a + b) % MOD;
+    int sum = a + b;
+    return sum >= MOD ? sum - MOD : sum;
 }
 
-// Modular subtraction
+// Modular subtraction; a and b must already be reduced into [0, MOD)
 int subtract(int a, int b) {
-    return (a - b + MOD) % MOD;
+    int diff = a - b;
+    return diff < 0 ? diff + MOD : diff;
 }
 
 // Modular multiplication
@@ -177,9 +617,9 @@ long long power(long long base, long long exp, long long mod) {
     
     while (exp > 0) {
         if (exp & 1) {
-            result = (result * base) % mod;
+            result = (__int128)result * base % mod;
         }
-        base = (base * base) % mod;
+        base = (__int128)base * base % mod;
         exp >>= 1;
     }
     
@@ -201,6 +641,181 @@ int modInverseExtended(int a, int mod) {
     return (x % mod + mod) % mod;
 }
 
+// ----------------------------------------------------------------------------
+// Division-free modular types
+// ----------------------------------------------------------------------------
+
+// Residue modulo a compile-time odd M < 2^30, stored in Montgomery form
+// (v = x * 2^32 mod M). A product costs three multiplies and no division:
+// t = a * b, q = t * M^-1 (low 32 bits only) and q * M, then a shift and one
+// conditional add. Division/inverse assume M is prime.
+// Canonical copy; 9_combinator_mathme/combinatorics_mathematics.cpp mirrors
+// it verbatim so that file stays standalone. Change both together.
+template <uint32_t M>
+struct ModInt {
+    static_assert(M % 2 == 1 && M < (1u << 30), "ModInt needs an odd modulus below 2^30");
+    
+    static constexpr uint32_t computeInv() {        // M^-1 mod 2^32 by Newton iteration
+        uint32_t inv = M;
+        for (int i = 0; i < 4; i++) inv *= 2 - M * inv;
+        return inv;
+    }
+    static constexpr uint32_t INV = computeInv();
+    static constexpr uint32_t R2 = -(uint64_t)M % M;    // 2^64 mod M
+    
+    uint32_t v;
+    
+    // t * 2^-32 mod M, for t < M * 2^32
+    static constexpr uint32_t reduce(uint64_t t) {
+        uint32_t m = (uint32_t)t * INV;
+        uint32_t r = (uint32_t)(t >> 32) - (uint32_t)(((uint64_t)m * M) >> 32);
+        return (int32_t)r < 0 ? r + M : r;
+    }
+    
+    constexpr ModInt() : v(0) {}
+    constexpr ModInt(long long x) : v(reduce((uint64_t)((x %= (long long)M) < 0 ? x + M : x) * R2)) {}
+    
+    static constexpr uint32_t mod() { return M; }
+    constexpr uint32_t val() const { return reduce(v); }
+    
+    constexpr ModInt& operator+=(ModInt o) {
+        v += o.v;
+        if (v >= M) v -= M;
+        return *this;
+    }
+    constexpr ModInt& operator-=(ModInt o) {
+        v = v >= o.v ? v - o.v : v + M - o.v;
+        return *this;
+    }
+    constexpr ModInt& operator*=(ModInt o) {
+        v = reduce((uint64_t)v * o.v);
+        return *this;
+    }
+    constexpr ModInt& operator/=(ModInt o) { return *this *= o.inv(); }
+    
+    friend constexpr ModInt operator+(ModInt a, ModInt b) { return a += b; }
+    friend constexpr ModInt operator-(ModInt a, ModInt b) { return a -= b; }
+    friend constexpr ModInt operator*(ModInt a, ModInt b) { return a *= b; }
+    friend constexpr ModInt operator/(ModInt a, ModInt b) { return a /= b; }
+    constexpr ModInt operator-() const { return ModInt() - *this; }
+    friend constexpr bool operator==(ModInt a, ModInt b) { return a.v == b.v; }
+    friend constexpr bool operator!=(ModInt a, ModInt b) { return a.v != b.v; }
+    
+    constexpr ModInt pow(unsigned long long exp) const {
+        ModInt result = 1, base = *this;
+        while (exp > 0) {
+            if (exp & 1) result *= base;
+            base *= base;
+            exp >>= 1;
+        }
+        return result;
+    }
+    constexpr ModInt inv() const { return pow(M - 2); }
+    
+    friend ostream& operator<<(ostream& os, ModInt x) { return os << x.val(); }
+};
+
+// Barrett reduction for a modulus chosen at runtime: x mod m is computed as
+// x - floor(x * ceil(2^64 / m) / 2^64) * m with one correction step
+struct Barrett {
+    uint32_t m;
+    uint64_t im;
+    
+    Barrett(uint32_t m) : m(m), im(~0ULL / m + 1) {}
+    
+    // x mod m for x < m^2
+    uint32_t reduce(uint64_t x) const {
+        uint64_t q = (uint64_t)(((unsigned __int128)x * im) >> 64);
+        uint32_t r = (uint32_t)(x - q * m);
+        return r >= m ? r + m : r;      // r wrapped below zero at most once
+    }
+    uint32_t mul(uint32_t a, uint32_t b) const { return reduce((uint64_t)a * b); }
+};
+
+// Residue modulo a runtime modulus 1 <= m < 2^31 shared by all instances;
+// call DynamicModInt::setMod before use
+struct DynamicModInt {
+    static inline Barrett bt = Barrett(MOD);
+    uint32_t v;
+    
+    static void setMod(uint32_t m) { bt = Barrett(m); }
+    static uint32_t mod() { return bt.m; }
+    
+    DynamicModInt() : v(0) {}
+    DynamicModInt(long long x) {
+        x %= (long long)mod();
+        v = x < 0 ? x + mod() : x;
+    }
+    
+    uint32_t val() const { return v; }
+    
+    DynamicModInt& operator+=(DynamicModInt o) {
+        v += o.v;
+        if (v >= mod()) v -= mod();
+        return *this;
+    }
+    DynamicModInt& operator-=(DynamicModInt o) {
+        v = v >= o.v ? v - o.v : v + mod() - o.v;
+        return *this;
+    }
+    DynamicModInt& operator*=(DynamicModInt o) {
+        v = bt.mul(v, o.v);
+        return *this;
+    }
+    DynamicModInt& operator/=(DynamicModInt o) { return *this *= o.inv(); }
+    
+    friend DynamicModInt operator+(DynamicModInt a, DynamicModInt b) { return a += b; }
+    friend DynamicModInt operator-(DynamicModInt a, DynamicModInt b) { return a -= b; }
+    friend DynamicModInt operator*(DynamicModInt a, DynamicModInt b) { return a *= b; }
+    friend DynamicModInt operator/(DynamicModInt a, DynamicModInt b) { return a /= b; }
+    friend bool operator==(DynamicModInt a, DynamicModInt b) { return a.v == b.v; }
+    friend bool operator!=(DynamicModInt a, DynamicModInt b) { return a.v != b.v; }
+    
+    DynamicModInt pow(unsigned long long exp) const {
+        DynamicModInt result = 1, base = *this;
+        while (exp > 0) {
+            if (exp & 1) result *= base;
+            base *= base;
+            exp >>= 1;
+        }
+        return result;
+    }
+    
+    // Extended Euclid, so m need not be prime (only gcd(v, m) = 1)
+    DynamicModInt inv() const {
+        long long a = v, b = mod(), x = 1, y = 0;
+        while (b) {
+            long long q = a / b;
+            swap(a -= q * b, b);
+            swap(x -= q * y, y);
+        }
+        return DynamicModInt(x);
+    }
+    
+    friend ostream& operator<<(ostream& os, DynamicModInt x) { return os << x.v; }
+};
+
+// Element-wise batch ops. The loops are branch-free on plain uint32 lanes, so
+// with -O3 (plus -mavx2 / -march=native) GCC and Clang vectorize them.
+template <uint32_t M>
+void modMulBatch(ModInt<M>* __restrict out, const ModInt<M>* __restrict a,
+                 const ModInt<M>* __restrict b, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] * b[i];
+}
+
+template <uint32_t M>
+void modAddBatch(ModInt<M>* __restrict out, const ModInt<M>* __restrict a,
+                 const ModInt<M>* __restrict b, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] + b[i];
+}
+
+// out[i] = a[i] * b[i] + c[i]
+template <uint32_t M>
+void modFmaBatch(ModInt<M>* __restrict out, const ModInt<M>* __restrict a,
+                 const ModInt<M>* __restrict b, const ModInt<M>* __restrict c, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] * b[i] + c[i];
+}
+
 // ============================================================================
 // EULER'S TOTIENT FUNCTION
 // ============================================================================
@@ -273,120 +888,450 @@ int chineseRemainder(vector<int>& a, vector<int>& m) {
 // COMBINATORICS
 // ============================================================================
 
-vector<long long> fact, invFact;
-
-// Precompute factorials and inverse factorials
-void precomputeFactorials(int n, int mod) {
-    fact.resize(n + 1);
-    invFact.resize(n + 1);
+// Factorials, inverse factorials and inverses of 1..n modulo a prime, built
+// in O(n) with a single exponentiation. Queries are const and O(1), so a
+// built table can be shared across threads; grow() must not run concurrently.
+// Mirror of BinomialTable in 9_combinator_mathme/combinatorics_mathematics.cpp
+// (the canonical copy), kept verbatim so this file stays standalone.
+class BinomialTable {
+private:
+    int mod;
+    vector<long long> fact, invFact, inv;
+    
+public:
+    BinomialTable(int n, int mod = MOD) : mod(mod), fact{1}, invFact{1}, inv{0} {
+        grow(n);
+    }
     
-    fact[0] = 1;
-    for (int i = 1; i <= n; i++) {
-        fact[i] = (fact[i - 1] * i) % mod;
+    int size() const { return fact.size() - 1; }     // largest n covered
+    int modulus() const { return mod; }
+    
+    // Extends the tables to cover n, at least doubling them so repeated growth
+    // is amortized O(1) per entry. n must be below mod, since n! == 0 from
+    // there on; use lucas() for C(n, r) mod a small prime with n >= p.
+    void grow(int n) {
+        assert(n < mod);
+        int oldN = size();
+        if (n <= oldN) return;
+        n = min(max(n, 2 * oldN), mod - 1);
+        fact.resize(n + 1);
+        invFact.resize(n + 1);
+        inv.resize(n + 1);
+        
+        for (int i = oldN + 1; i <= n; i++) fact[i] = fact[i - 1] * i % mod;
+        invFact[n] = power(fact[n], mod - 2, mod);
+        for (int i = n; i > oldN + 1; i--) invFact[i - 1] = invFact[i] * i % mod;
+        for (int i = oldN + 1; i <= n; i++) inv[i] = invFact[i] * fact[i - 1] % mod;
     }
     
-    invFact[n] = modInverseFermat(fact[n], mod);
-    for (int i = n - 1; i >= 0; i--) {
-        invFact[i] = (invFact[i + 1] * (i + 1)) % mod;
+    long long factorial(int n) const { return n >= 0 && n <= size() ? fact[n] : 0; }
+    long long inverseFactorial(int n) const { return n >= 0 && n <= size() ? invFact[n] : 0; }
+    long long inverse(int n) const { return n >= 1 && n <= size() ? inv[n] : 0; }
+    
+    // C(n, r); 0 when r is out of [0, n] or n is beyond the table (grow() first)
+    long long nCr(int n, int r) const {
+        if (r < 0 || r > n || n > size()) return 0;
+        return fact[n] * invFact[r] % mod * invFact[n - r] % mod;
     }
-}
-
-// nCr mod p
-long long nCr(int n, int r, int mod) {
-    if (r > n || r < 0) return 0;
-    return (fact[n] * invFact[r] % mod) * invFact[n - r] % mod;
-}
-
-// Permutation: P(n, r) = n! / (n-r)!
-long long permutation(int n, int r, int mod) {
-    if (r > n) return 0;
-    return (fact[n] * invFact[n - r]) % mod;
-}
-
-// Catalan numbers
-long long catalan(int n, int mod) {
-    return nCr(2 * n, n, mod) * modInverseFermat(n + 1, mod) % mod;
-}
+    
+    // P(n, r) = n! / (n-r)!; 0 when out of range as for nCr
+    long long nPr(int n, int r) const {
+        if (r < 0 || r > n || n > size()) return 0;
+        return fact[n] * invFact[n - r] % mod;
+    }
+    
+    // Catalan(n) = (2n)! / ((n+1)! n!); 0 when 2n is beyond the table
+    long long catalan(int n) const {
+        if (n < 0 || 2LL * n > size()) return 0;
+        if (n == 0) return 1 % mod;         // invFact[n + 1] may not exist yet
+        return fact[2 * n] * invFact[n + 1] % mod * invFact[n] % mod;
+    }
+};
 
 // ============================================================================
 // ADVANCED ALGORITHMS
 // ============================================================================
 
-// Miller-Rabin primality test
-bool millerRabin(long long n, int k = 5) {
-    if (n <= 1 || n == 4) return false;
-    if (n <= 3) return true;
+// Montgomery arithmetic modulo an odd 64-bit n: values are kept as x * 2^64
+// mod n so each product costs two 64x64->128 multiplies and no division
+struct Montgomery64 {
+    uint64_t mod, inv, r2;      // inv = mod^-1 mod 2^64, r2 = 2^128 mod mod
+    
+    Montgomery64(uint64_t n) : mod(n), inv(n) {
+        // n * n == 1 (mod 8), so the seed inv = n is right to 3 bits and each
+        // Newton step doubles that: 3 -> 6 -> 12 -> 24 -> 48 -> 96 >= 64 needs all 5
+        for (int i = 0; i < 5; i++) inv *= 2 - n * inv;
+        r2 = (-(unsigned __int128)n) % n;
+    }
     
-    long long d = n - 1;
-    while (d % 2 == 0) {
-        d /= 2;
+    // t * 2^-64 mod n, for t < n * 2^64
+    uint64_t reduce(unsigned __int128 t) const {
+        uint64_t m = (uint64_t)t * inv;
+        uint64_t hi = t >> 64, sub = ((unsigned __int128)m * mod) >> 64;
+        return hi >= sub ? hi - sub : hi - sub + mod;
     }
     
-    for (int i = 0; i < k; i++) {
-        long long a = 2 + rand() % (n - 4);
-        long long x = power(a, d, n);
-        
-        if (x == 1 || x == n - 1) continue;
+    uint64_t toMont(uint64_t x) const { return reduce((unsigned __int128)(x % mod) * r2); }
+    uint64_t fromMont(uint64_t x) const { return reduce(x); }
+    uint64_t one() const { return toMont(1); }
+    uint64_t mul(uint64_t a, uint64_t b) const { return reduce((unsigned __int128)a * b); }
+    uint64_t add(uint64_t a, uint64_t b) const { return a >= mod - b ? a - (mod - b) : a + b; }
+    uint64_t sub(uint64_t a, uint64_t b) const { return a >= b ? a - b : a + (mod - b); }
+    
+    uint64_t pow(uint64_t base, uint64_t exp) const {
+        uint64_t result = one();
+        while (exp > 0) {
+            if (exp & 1) result = mul(result, base);
+            base = mul(base, base);
+            exp >>= 1;
+        }
+        return result;
+    }
+};
+
+// Deterministic Miller-Rabin for all n < 2^64 (Jaeschke/Sinclair base set)
+bool millerRabin(uint64_t n) {
+    if (n < 2) return false;
+    for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+        if (n % p == 0) return n == p;
+    }
+    if (n < 37 * 37) return true;
+    
+    int s = __builtin_ctzll(n - 1);
+    uint64_t d = (n - 1) >> s;
+    Montgomery64 mont(n);
+    uint64_t one = mont.one(), minusOne = mont.sub(0, one);
+    
+    for (uint64_t a : {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL}) {
+        uint64_t base = mont.toMont(a);
+        if (base == 0) continue;
+        uint64_t x = mont.pow(base, d);
+        if (x == one || x == minusOne) continue;
         
         bool composite = true;
-        for (int j = 0; j < d - 1; j++) {
-            x = (x * x) % n;
-            if (x == n - 1) {
+        for (int r = 1; r < s; r++) {
+            x = mont.mul(x, x);
+            if (x == minusOne) {
                 composite = false;
                 break;
             }
         }
-        
         if (composite) return false;
     }
     
     return true;
 }
 
-// Pollard's Rho algorithm for factorization
-long long pollardRho(long long n) {
-    if (n == 1) return 1;
+// Tests many candidates at once, striping the batch across threads
+vector<char> millerRabinBatch(const vector<uint64_t>& candidates,
+                              int threads = max(1u, thread::hardware_concurrency())) {
+    vector<char> result(candidates.size());
+    threads = max(1, min<int>(threads, candidates.size()));
+    size_t stripe = (candidates.size() + threads - 1) / threads;
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        size_t from = t * stripe, to = min(candidates.size(), from + stripe);
+        workers.emplace_back([&, from, to]() {
+            for (size_t i = from; i < to; i++) result[i] = millerRabin(candidates[i]);
+        });
+    }
+    for (thread& w : workers) w.join();
+    return result;
+}
+
+// Pollard's Rho with Brent's cycle detection: |x - y| terms are multiplied
+// together and gcd'd once per batch, with backtracking if a batch overshoots.
+// Returns a nontrivial factor of a composite n.
+uint64_t pollardRho(uint64_t n) {
     if (n % 2 == 0) return 2;
     
-    long long x = rand() % (n - 2) + 2;
-    long long y = x;
-    long long c = rand() % (n - 1) + 1;
-    long long d = 1;
+    const uint64_t BATCH = 128;
+    Montgomery64 mont(n);
+    for (uint64_t seed = 1; ; seed++) {
+        uint64_t c = mont.toMont(seed), y = mont.toMont(seed + 1), x = y, ys = y;
+        uint64_t q = mont.one(), g = 1;
+        auto f = [&](uint64_t v) { return mont.add(mont.mul(v, v), c); };
+        
+        for (uint64_t r = 1; g == 1; r <<= 1) {
+            x = y;
+            for (uint64_t i = 0; i < r; i++) y = f(y);
+            for (uint64_t k = 0; k < r && g == 1; k += BATCH) {
+                ys = y;
+                for (uint64_t i = 0; i < min(BATCH, r - k); i++) {
+                    y = f(y);
+                    q = mont.mul(q, x > y ? x - y : y - x);
+                }
+                g = std::gcd(q, n);
+            }
+        }
+        if (g == n) {
+            do {
+                ys = f(ys);
+                g = std::gcd(x > ys ? x - ys : ys - x, n);
+            } while (g == 1);
+        }
+        if (g != n) return g;    // otherwise the cycle closed mod n: retry with a new c
+    }
+}
+
+// Prime factorization of any 64-bit n as sorted (prime, exponent) pairs:
+// trial division by primes below 1000, then Miller-Rabin + Brent rho
+vector<pair<uint64_t, int>> factorize(uint64_t n) {
+    static const vector<int> smallPrimes = getPrimes(1000);
+    vector<pair<uint64_t, int>> factors;
+    for (int p : smallPrimes) {
+        if ((uint64_t)p * p > n) break;
+        if (n % p) continue;
+        int e = 0;
+        while (n % p == 0) {
+            n /= p;
+            e++;
+        }
+        factors.push_back({p, e});
+    }
     
-    while (d == 1) {
-        x = (power(x, 2, n) + c) % n;
-        y = (power(y, 2, n) + c) % n;
-        y = (power(y, 2, n) + c) % n;
-        d = gcd(abs(x - y), n);
+    vector<uint64_t> large, pending;
+    if (n > 1) pending.push_back(n);
+    while (!pending.empty()) {
+        uint64_t m = pending.back();
+        pending.pop_back();
+        if (m < 1000000 || millerRabin(m)) {     // no factor below 1000 left
+            large.push_back(m);
+            continue;
+        }
+        uint64_t d = pollardRho(m);
+        pending.push_back(d);
+        pending.push_back(m / d);
     }
     
-    return d;
+    sort(large.begin(), large.end());
+    for (uint64_t p : large) {
+        if (!factors.empty() && factors.back().first == p) factors.back().second++;
+        else factors.push_back({p, 1});
+    }
+    return factors;
+}
+
+// ----------------------------------------------------------------------------
+// Discrete logarithm
+// ----------------------------------------------------------------------------
+
+// Multiplication modulo any 64-bit m: Montgomery form when m is odd, a plain
+// 128-bit remainder otherwise. Values passed to mul/pow must come from in().
+struct MulMod64 {
+    uint64_t m;
+    bool odd;
+    Montgomery64 mont;
+    
+    MulMod64(uint64_t m) : m(m), odd(m & 1), mont(m | 1) {}
+    
+    uint64_t in(uint64_t x) const { return odd ? mont.toMont(x) : x % m; }
+    uint64_t out(uint64_t x) const { return odd ? mont.fromMont(x) : x; }
+    uint64_t mul(uint64_t a, uint64_t b) const {
+        return odd ? mont.mul(a, b) : (uint64_t)((unsigned __int128)a * b % m);
+    }
+    uint64_t pow(uint64_t base, uint64_t exp) const {
+        uint64_t result = in(1);
+        while (exp > 0) {
+            if (exp & 1) result = mul(result, base);
+            base = mul(base, base);
+            exp >>= 1;
+        }
+        return result;
+    }
+};
+
+// Inverse of a modulo m by extended Euclid, or 0 when gcd(a, m) != 1
+uint64_t inverseMod64(uint64_t a, uint64_t m) {
+    if (m == 1) return 0;
+    __int128 oldR = a % m, r = m, oldS = 1, s = 0;
+    while (r != 0) {
+        __int128 q = oldR / r;
+        swap(oldR -= q * r, r);
+        swap(oldS -= q * s, s);
+    }
+    if (oldR != 1) return 0;
+    return (uint64_t)((oldS % (__int128)m + m) % m);
 }
 
-// Discrete logarithm using Baby-step Giant-step
-int discreteLog(int a, int b, int m) {
-    int n = sqrt(m) + 1;
+// Open-addressing hash map from 64-bit keys to 64-bit values: one flat array
+// sized to a power of two >= 2x the expected entries, linear probing and
+// Fibonacci hashing. ~0 marks an empty slot, so it cannot be a key.
+class FlatHashMap {
+private:
+    static constexpr uint64_t EMPTY = ~0ULL;
+    vector<uint64_t> keys, values;
+    int shift;
+    size_t mask;
+    
+    size_t slot(uint64_t key) const { return (key * 0x9E3779B97F4A7C15ULL) >> shift; }
+    
+public:
+    FlatHashMap(size_t expected) {
+        int bits = 1;
+        while ((1ULL << bits) < 2 * expected) bits++;
+        keys.assign(1ULL << bits, EMPTY);
+        values.resize(1ULL << bits);
+        shift = 64 - bits;
+        mask = (1ULL << bits) - 1;
+    }
     
-    // Baby-step
-    unordered_map<int, int> baby;
-    int an = power(a, n, m);
+    // Keeps the existing value if key is already present
+    void insert(uint64_t key, uint64_t value) {
+        size_t i = slot(key);
+        while (keys[i] != EMPTY && keys[i] != key) i = (i + 1) & mask;
+        if (keys[i] == EMPTY) {
+            keys[i] = key;
+            values[i] = value;
+        }
+    }
+    
+    bool find(uint64_t key, uint64_t& value) const {
+        for (size_t i = slot(key); keys[i] != EMPTY; i = (i + 1) & mask) {
+            if (keys[i] == key) {
+                value = values[i];
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Baby-step giant-step for a^x = b (mod m) with gcd(a, m) = 1 and x < bound.
+// The baby steps a^j, j < ceil(sqrt(bound)), are tabulated once, so repeated
+// log() calls with the same base cost O(sqrt(bound)) lookups each.
+class BabyStepGiantStep {
+private:
+    MulMod64 mm;
+    uint64_t steps, giant;      // giant = a^-steps, in mm's internal form
+    FlatHashMap baby;
+    
+public:
+    BabyStepGiantStep(uint64_t a, uint64_t m, uint64_t bound)
+        : mm(m), steps(max<uint64_t>(1, ceill(sqrtl((long double)bound)))), baby(steps) {
+        uint64_t base = mm.in(a), power = mm.in(1);
+        for (uint64_t j = 0; j < steps; j++) {
+            baby.insert(power, j);
+            power = mm.mul(power, base);
+        }
+        giant = mm.pow(mm.in(inverseMod64(a, m)), steps);
+    }
     
-    for (int p = 1, val = an; p <= n; p++) {
-        if (baby.find(val) == baby.end()) {
-            baby[val] = p;
+    // Smallest x < steps^2 with a^x = b, or -1
+    long long log(uint64_t b) const {
+        uint64_t gamma = mm.in(b), j;
+        for (uint64_t i = 0; i < steps; i++) {
+            if (baby.find(gamma, j)) return i * steps + j;
+            gamma = mm.mul(gamma, giant);
+        }
+        return -1;
+    }
+};
+
+// Carmichael function: the exponent of (Z/mZ)*, so ord(a) | lambda(m) for
+// every unit a. lambda(p^e) = p^(e-1) * (p - 1), except lambda(2^e) = 2^(e-2)
+// for e >= 3; lambda(m) is the lcm over the prime powers of m.
+uint64_t carmichaelLambda(uint64_t m) {
+    uint64_t lambda = 1;
+    for (auto& [p, e] : factorize(m)) {
+        uint64_t term = p - 1;
+        for (int i = 1; i < e; i++) term *= p;
+        if (p == 2 && e >= 3) term /= 2;
+        lambda = lambda / std::gcd(lambda, term) * term;
+    }
+    return lambda;
+}
+
+// Discrete log modulo m via Pohlig-Hellman on the cyclic group <a>: ord(a)
+// is cut down from lambda(m), x is recovered modulo each prime power q^e of
+// ord(a) from logs in the order-q subgroup (a BSGS table of size sqrt(q) per
+// q, built once), then combined by CRT. Needs gcd(a, m) = 1 and m < 2^63;
+// memory is O(sqrt(largest prime of ord(a))), fast whenever that is small.
+class PohligHellman {
+private:
+    struct Component {
+        uint64_t q;
+        int e;
+        uint64_t gamma;                 // a^(order / q), generates the order-q subgroup
+        BabyStepGiantStep subgroupLog;
+    };
+    
+    MulMod64 mm;
+    uint64_t p, a, order;               // p is the modulus, prime or not
+    vector<Component> components;
+    
+public:
+    PohligHellman(uint64_t a, uint64_t p) : mm(p), p(p), a(a % p), order(carmichaelLambda(p)) {
+        assert(std::gcd(this->a, p) == 1);
+        uint64_t base = mm.in(this->a);
+        auto factors = factorize(order);
+        for (auto& [q, e] : factors) {      // shrink lambda(p) down to ord(a)
+            while (order % q == 0 && mm.out(mm.pow(base, order / q)) == 1) order /= q;
+        }
+        for (auto& [q, e] : factors) {
+            int exponent = 0;
+            for (uint64_t rest = order; rest % q == 0; rest /= q) exponent++;
+            if (exponent == 0) continue;
+            uint64_t gamma = mm.out(mm.pow(base, order / q));
+            components.push_back({q, exponent, gamma, BabyStepGiantStep(gamma, p, q)});
         }
-        val = (val * an) % m;
     }
     
-    // Giant-step
-    for (int q = 0, val = b; q <= n; q++) {
-        if (baby.find(val) != baby.end()) {
-            return baby[val] * n - q;
+    uint64_t subgroupOrder() const { return order; }
+    
+    // Smallest x >= 0 with a^x = b (mod p), or -1
+    long long log(uint64_t b) const {
+        b %= p;
+        if (std::gcd(b, p) != 1) return -1;
+        uint64_t base = mm.in(a), target = mm.in(b), inverseBase = mm.in(inverseMod64(a, p));
+        unsigned __int128 x = 0, modulus = 1;      // CRT accumulator
+        
+        for (const Component& c : components) {
+            // x mod q^e digit by digit: d_i = log_gamma((b * a^-known)^(order / q^(i+1)))
+            uint64_t known = 0, qPower = 1, exponent = order;
+            for (int i = 0; i < c.e; i++) {
+                exponent /= c.q;
+                uint64_t h = mm.out(mm.pow(mm.mul(target, mm.pow(inverseBase, known)), exponent));
+                long long digit = c.subgroupLog.log(h);
+                if (digit < 0) return -1;
+                known += digit * qPower;
+                qPower *= c.q;
+            }
+            // Merge x = known (mod qPower) into the accumulator
+            uint64_t shift = (uint64_t)(((known + qPower - (uint64_t)(x % qPower)) % qPower));
+            uint64_t step = (uint64_t)((unsigned __int128)shift * inverseMod64((uint64_t)(modulus % qPower), qPower) % qPower);
+            x += modulus * step;
+            modulus *= qPower;
         }
-        val = (val * a) % m;
+        
+        if (mm.pow(base, (uint64_t)x) != target) return -1;
+        return (long long)x;
     }
+};
+
+// Smallest x >= 0 with a^x = b (mod m) for any m < 2^63, or -1. Common factors
+// of a and m are peeled off first (x below that point is checked directly),
+// leaving k * a^x' = b' with gcd(a, m') = 1, which Pohlig-Hellman solves in
+// the group <a> for prime and composite m' alike. A single BSGS over all of
+// m' would need a sqrt(m') table, up to 3 * 10^9 entries for 64-bit moduli.
+long long discreteLog(uint64_t a, uint64_t b, uint64_t m) {
+    if (m == 1) return 0;
+    a %= m;
+    b %= m;
+    uint64_t k = 1 % m, added = 0, g;
+    while ((g = std::gcd(a, m)) > 1) {
+        if (b == k) return added;
+        if (b % g != 0) return -1;
+        b /= g;
+        m /= g;
+        added++;
+        k = (uint64_t)((unsigned __int128)k * (a / g) % m);
+    }
+    if (m == 1) return added;
     
-    return -1; // Not found
+    uint64_t target = (uint64_t)((unsigned __int128)b * inverseMod64(k, m) % m);
+    long long x = PohligHellman(a, m).log(target);
+    return x < 0 ? -1 : x + added;
 }
 
 // ============================================================================
@@ -399,40 +1344,25 @@ bool isCoprime(int a, int b) {
 }
 
 // Count number of divisors
-int countDivisors(int n) {
+int countDivisors(uint64_t n) {
     int count = 1;
-    vector<int> factors = getPrimeFactors(n);
-    
-    unordered_map<int, int> factorCount;
-    for (int factor : factors) {
-        factorCount[factor]++;
-    }
-    
-    for (auto& p : factorCount) {
-        count *= (p.second + 1);
+    for (auto& [p, e] : factorize(n)) {
+        count *= e + 1;
     }
-    
     return count;
 }
 
-// Sum of divisors
-long long sumOfDivisors(int n) {
-    long long sum = 1;
-    vector<int> factors = getPrimeFactors(n);
-    
-    unordered_map<int, int> factorCount;
-    for (int factor : factors) {
-        factorCount[factor]++;
-    }
-    
-    for (auto& p : factorCount) {
-        long long term = 1;
-        for (int i = 0; i <= p.second; i++) {
-            term *= p.first;
+// Sum of divisors (fits in 64 bits for n up to about 10^18)
+unsigned long long sumOfDivisors(uint64_t n) {
+    unsigned long long sum = 1;
+    for (auto& [p, e] : factorize(n)) {
+        unsigned long long term = 1, power = 1;     // 1 + p + ... + p^e
+        for (int i = 0; i < e; i++) {
+            power *= p;
+            term += power;
         }
-        sum *= (term - 1) / (p.first - 1);
+        sum *= term;
     }
-    
     return sum;
 }
 
@@ -476,6 +1406,85 @@ void testSieve() {
     cout << endl;
 }
 
+void testPrimeSieve() {
+    cout << "Testing Segmented Prime Sieve:" << endl;
+    
+    PrimeSieve ps(1000000000LL);
+    cout << "pi(10^6): " << ps.count(1, 1000000) << endl;
+    cout << "pi(10^9): " << ps.count(1, 1000000000LL) << endl;
+    
+    cout << "Primes in [999900, 1000000]: ";
+    ps.forEachPrime(999900, 1000000, [](long long p) { cout << p << " "; });
+    cout << endl;
+    
+    cout << "pi(10^9) on 4 threads: " << ps.countParallel(1, 1000000000LL, 4) << endl;
+    
+    long long streamed = 0, last = 0;
+    segmentedSieve(100000000000LL, 100010000000LL, [&](const vector<long long>& chunk) {
+        streamed += chunk.size();
+        last = chunk.back();
+    });
+    cout << "Primes in [10^11, 10^11 + 10^7]: " << streamed << " (last " << last << ")" << endl;
+    
+    PrimeSieve::Iterator it = ps.primes(1, 100);
+    cout << "First primes from iterator: ";
+    for (long long p = it.next(); p != -1 && p < 30; p = it.next()) cout << p << " ";
+    cout << endl;
+    
+    cout << endl;
+}
+
+void testLinearSieve() {
+    cout << "Testing Linear Sieve:" << endl;
+    
+    LinearSieve ls(10000000);
+    cout << "Primes up to 10^7: " << ls.getPrimes().size() << endl;
+    cout << "phi(36) = " << ls.totient(36) << ", mu(30) = " << ls.mobius(30)
+         << ", d(720720) = " << ls.divisorCount(720720) << endl;
+    
+    cout << "Factorization of 9699690: ";
+    for (auto& [p, e] : ls.factorize(9699690)) cout << p << "^" << e << " ";
+    cout << endl;
+    
+    // Bulk factorization is a table walk per number
+    long long totalFactors = 0;
+    for (int x = 2; x <= ls.size(); x++) totalFactors += ls.factorize(x).size();
+    cout << "Distinct prime factors summed over [2, 10^7]: " << totalFactors << endl;
+    
+    cout << endl;
+}
+
+void testPrimeCounting() {
+    cout << "Testing Sub-linear Prime Counting:" << endl;
+    
+    cout << "pi(10^12): " << primeCount(1000000000000LL) << endl;
+    cout << "sum of primes <= 10^11: " << int128ToString(primeSum(100000000000LL)) << endl;
+    
+    // Mertens function: f(p) = -1, f(p^e) = 0 for e >= 2
+    long long x = 10000000000LL;
+    LucySieve<long long> count(x, [](long long v) { return v - 1; }, [](long long) { return 1LL; });
+    long long mertens = multiplicativePrefixSum<long long>(
+        x, [&](long long v) { return -count(v); },
+        [](long long, int e) { return e == 1 ? -1LL : 0LL; });
+    cout << "M(10^10): " << mertens << endl;
+    
+    // Totient summatory: f(p^e) = p^e - p^(e-1), so f(p) = p - 1
+    LucySieve<__int128> sum(x, [](long long v) { return (__int128)v * (v + 1) / 2 - 1; },
+                            [](long long p) { return (__int128)p; });
+    __int128 totients = multiplicativePrefixSum<__int128>(
+        x, [&](long long v) { return sum(v) - count(v); },
+        [](long long p, int e) {
+            __int128 pe = 1;
+            for (int i = 1; i < e; i++) pe *= p;
+            return pe * (p - 1);
+        });
+    cout << "sum of phi(n), n <= 10^10: " << int128ToString(totients) << endl;
+    
+    cout << "sum of d(n), n <= 10^12: " << divisorSummatory(1000000000000LL) << endl;
+    
+    cout << endl;
+}
+
 void testModularArithmetic() {
     cout << "Testing Modular Arithmetic:" << endl;
     
@@ -488,23 +1497,191 @@ void testModularArithmetic() {
     cout << endl;
 }
 
+void testPrimality() {
+    cout << "Testing 64-bit Primality:" << endl;
+    
+    cout << "millerRabin(2^61 - 1): " << millerRabin((1ULL << 61) - 1) << endl;
+    cout << "millerRabin(2^64 - 59): " << millerRabin(18446744073709551557ULL) << endl;
+    cout << "millerRabin(561) [Carmichael]: " << millerRabin(561) << endl;
+    cout << "millerRabin(3215031751) [strong pseudoprime to 2,3,5,7]: " << millerRabin(3215031751ULL) << endl;
+    
+    cout << endl;
+}
+
+void testFactorization() {
+    cout << "Testing 64-bit Factorization:" << endl;
+    
+    for (uint64_t n : {360ULL, 600851475143ULL, 1000000007ULL * 998244353ULL,
+                       4611686014132420609ULL, 18446744073709551615ULL}) {
+        cout << n << " = ";
+        auto factors = factorize(n);
+        for (size_t i = 0; i < factors.size(); i++) {
+            cout << factors[i].first << "^" << factors[i].second << (i + 1 < factors.size() ? " * " : "");
+        }
+        cout << endl;
+    }
+    cout << "countDivisors(720720): " << countDivisors(720720) << endl;
+    cout << "sumOfDivisors(720720): " << sumOfDivisors(720720) << endl;
+    
+    cout << endl;
+}
+
+void testDiscreteLog() {
+    cout << "Testing Discrete Logarithm:" << endl;
+    
+    cout << "log_2(9) mod 23: " << discreteLog(2, 9, 23) << endl;
+    cout << "log_3(13) mod 17: " << discreteLog(3, 13, 17) << endl;
+    cout << "log_2(8) mod 24 [gcd(a, m) > 1]: " << discreteLog(2, 8, 24) << endl;
+    cout << "log_2(3) mod 4 [no solution]: " << discreteLog(2, 3, 4) << endl;
+    
+    // Composite m = 2^30 * 3^15 * 5^3 ~ 1.9 * 10^18: a single BSGS would tabulate
+    // sqrt(m) ~ 1.4 * 10^9 steps, Pohlig-Hellman only sqrt(q) per prime q | ord(7)
+    uint64_t m = (1ULL << 30) * 14348907 * 125;
+    MulMod64 mmComposite(m);
+    uint64_t y = mmComposite.out(mmComposite.pow(mmComposite.in(7), 987654321));
+    cout << "log_7(7^987654321) mod " << m << ": " << discreteLog(7, y, m) << endl;
+    
+    // p - 1 = 2^2 * 3^4 * 5^3 * 7^4 * 11 * 13 * 17 * 19 * 23 is smooth: one table
+    // of size sqrt(q) per prime q serves every query against base 3
+    uint64_t p = 2ULL * 2 * 81 * 125 * 2401 * 11 * 13 * 17 * 19 * 23 + 1;
+    if (millerRabin(p)) {
+        PohligHellman ph(3, p);
+        MulMod64 mm(p);
+        uint64_t b = mm.out(mm.pow(mm.in(3), 123456789012ULL));
+        cout << "log_3(3^123456789012) mod " << p << ": " << ph.log(b)
+             << " (ord(3) = " << ph.subgroupOrder() << ")" << endl;
+    }
+    
+    // Repeated queries reuse one baby-step table
+    BabyStepGiantStep bsgs(5, 1000000007, 1000000006);
+    cout << "log_5(2), log_5(3) mod 1e9+7: " << bsgs.log(2) << ", " << bsgs.log(3) << endl;
+    
+    cout << endl;
+}
+
+void testModInt() {
+    cout << "Testing ModInt:" << endl;
+    
+    using Mint = ModInt<998244353>;
+    Mint a = 123456789, b = -5;
+    cout << "a * b mod 998244353: " << a * b << endl;
+    cout << "a / a: " << a / a << ", 3^-1 * 3: " << Mint(3).inv() * 3 << endl;
+    cout << "2^(p-1) mod p: " << Mint(2).pow(998244352) << endl;
+    
+    DynamicModInt::setMod(1000000);     // composite modulus at runtime
+    DynamicModInt c = 999999;
+    cout << "999999^2 mod 10^6: " << c * c << ", 7^-1 mod 10^6: " << DynamicModInt(7).inv() << endl;
+    DynamicModInt::setMod(MOD);
+    
+    cout << endl;
+}
+
 void testCombinatorics() {
     cout << "Testing Combinatorics:" << endl;
     
-    precomputeFactorials(10, MOD);
+    BinomialTable binom(10, MOD);
     
     // Test combinations
-    cout << "C(5, 2): " << nCr(5, 2, MOD) << endl;
+    cout << "C(5, 2): " << binom.nCr(5, 2) << endl;
     
     // Test permutations
-    cout << "P(5, 2): " << permutation(5, 2, MOD) << endl;
+    cout << "P(5, 2): " << binom.nPr(5, 2) << endl;
     
     // Test Catalan numbers
-    cout << "Catalan(4): " << catalan(4, MOD) << endl;
+    cout << "Catalan(4): " << binom.catalan(4) << endl;
+    
+    // Tables grow on demand, doubling to stay amortized O(1) per entry
+    binom.grow(1000000);
+    cout << "C(10^6, 5 * 10^5) mod p: " << binom.nCr(1000000, 500000) << endl;
+    cout << "1 / 999999 * 999999: " << binom.inverse(999999) * 999999 % MOD << endl;
     
     cout << endl;
 }
 
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+void benchmarkPrimality(int count) {
+    cout << "Benchmarking Primality (" << count << " random odd 64-bit candidates):" << endl;
+    
+    mt19937_64 rng(12345);
+    vector<uint64_t> candidates(count);
+    for (uint64_t& c : candidates) c = rng() | 1 | (1ULL << 63);
+    
+    auto time = [](auto&& fn) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+    
+    int primes = 0;
+    double single = time([&]() {
+        for (uint64_t c : candidates) primes += millerRabin(c);
+    });
+    vector<char> batch;
+    int threads = max(1u, thread::hardware_concurrency());
+    double parallel = time([&]() { batch = millerRabinBatch(candidates, threads); });
+    
+    cout << fixed << setprecision(2);
+    cout << "  primes found: " << primes << " (batch agrees: "
+         << (count_if(batch.begin(), batch.end(), [](char b) { return b; }) == primes) << ")" << endl;
+    cout << "  single thread: " << count / single / 1e6 << " M tests/s" << endl;
+    cout << "  batch, " << threads << " threads: " << count / parallel / 1e6 << " M tests/s" << endl;
+    cout << defaultfloat << endl;
+}
+
+void benchmarkModular(int n, int rounds) {
+    cout << "Benchmarking Modular Multiply (" << n << " elements x " << rounds << " rounds):" << endl;
+    
+    using Mint = ModInt<998244353>;
+    mt19937 rng(7);
+    vector<uint32_t> ra(n), rb(n), rc(n);
+    for (int i = 0; i < n; i++) ra[i] = rng() % Mint::mod(), rb[i] = rng() % Mint::mod();
+    vector<Mint> ma(ra.begin(), ra.end()), mb(rb.begin(), rb.end()), mc(n);
+    vector<DynamicModInt> da, db, dc(n);
+    DynamicModInt::setMod(Mint::mod());
+    for (int i = 0; i < n; i++) da.push_back(ra[i]), db.push_back(rb[i]);
+    volatile uint32_t runtimeMod = Mint::mod();     // keeps the compiler from strength-reducing the %
+    
+    auto time = [](auto&& fn) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+    
+    double tDiv = time([&]() {
+        uint32_t m = runtimeMod;
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < n; i++) rc[i] = (uint64_t)ra[i] * rb[i] % m;
+            swap(ra, rc);
+        }
+    });
+    double tBarrett = time([&]() {
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < n; i++) dc[i] = da[i] * db[i];
+            swap(da, dc);
+        }
+    });
+    double tMont = time([&]() {
+        for (int r = 0; r < rounds; r++) {
+            modMulBatch(mc.data(), ma.data(), mb.data(), n);
+            swap(ma, mc);
+        }
+    });
+    
+    bool agree = true;
+    for (int i = 0; i < n; i++) agree &= ra[i] == ma[i].val() && ra[i] == da[i].val();
+    double ops = (double)n * rounds / 1e6;
+    cout << fixed << setprecision(1);
+    cout << "  % runtime modulus:        " << ops / tDiv << " M mul/s" << endl;
+    cout << "  DynamicModInt (Barrett):  " << ops / tBarrett << " M mul/s" << endl;
+    cout << "  modMulBatch (Montgomery): " << ops / tMont << " M mul/s" << endl;
+    cout << "  results agree: " << agree << endl;
+    cout << defaultfloat << endl;
+    DynamicModInt::setMod(MOD);
+}
+
 // ============================================================================
 // MAIN FUNCTION
 // ============================================================================
@@ -518,8 +1695,18 @@ int main() {
     
     testBasicFunctions();
     testSieve();
+    testPrimeSieve();
+    testLinearSieve();
+    testPrimeCounting();
     testModularArithmetic();
     testCombinatorics();
+    testPrimality();
+    testFactorization();
+    testModInt();
+    testDiscreteLog();
+    
+    benchmarkPrimality(1000000);
+    benchmarkModular(1 << 16, 500);
     
     return 0;
 }
@@ -103,18 +103,9 @@ vector<long long> prefixProduct(vector<int>& arr, int mod = 1e9 + 7) {
     return prefix;
 }
 
-long long queryProduct(vector<long long>& prefix, int i, int j, int mod = 1e9 + 7) {
-    if (i == 0) return prefix[j];
-    
-    // Compute modular inverse
-    long long inv = modInverse(prefix[i-1], mod);
-    return (prefix[j] * inv) % mod;
-}
-
-long long modInverse(long long a, int mod) {
-    return power(a, mod - 2, mod);
-}
-
+// These helpers take the modulus per call and run once per query, so they
+// stay on plain %. For division-free hot loops use ModInt / DynamicModInt
+// from 2_NumberTheory/number_theory_algorithms.cpp.
 long long power(long long base, long long exp, int mod) {
     long long result = 1;
     base %= mod;
@@ -130,6 +121,18 @@ long long power(long long base, long long exp, int mod) {
     return result;
 }
 
+long long modInverse(long long a, int mod) {
+    return power(a, mod - 2, mod);
+}
+
+long long queryProduct(vector<long long>& prefix, int i, int j, int mod = 1e9 + 7) {
+    if (i == 0) return prefix[j];
+    
+    // Compute modular inverse
+    long long inv = modInverse(prefix[i-1], mod);
+    return (prefix[j] * inv) % mod;
+}
+
 // ============================================================================
 // CUMULATIVE FREQUENCY
 // ============================================================================
@@ -383,39 +386,45 @@ vector<int> kmpSearch(string& text, string& pattern) {
 // SPARSE TABLE
 // ============================================================================
 
+template <typename T>
+struct MinOp {
+    static T combine(const T& a, const T& b) { return min(a, b); }
+};
+
+template <typename T>
+struct MaxOp {
+    static T combine(const T& a, const T& b) { return max(a, b); }
+};
+
+// O(1) queries for idempotent operations. Levels are stored one after
+// another in one flat array: table[k * n + i] covers [i, i + 2^k).
+template <typename T, typename Op = MinOp<T>>
 class SparseTable {
 private:
-    vector<vector<int>> table;
-    vector<int> logTable;
-    int n;
+    vector<T> table;
+    int n, levels;
     
 public:
-    SparseTable(vector<int>& arr) {
+    SparseTable(const vector<T>& arr) {
         n = arr.size();
-        int logn = log2(n) + 1;
-        table.resize(n, vector<int>(logn));
-        
-        for (int i = 0; i < n; i++) {
-            table[i][0] = arr[i];
-        }
+        levels = n ? __lg(n) + 1 : 0;
+        table.resize((size_t)n * levels);
+        copy(arr.begin(), arr.end(), table.begin());
         
-        for (int j = 1; (1 << j) <= n; j++) {
-            for (int i = 0; i + (1 << j) <= n; i++) {
-                table[i][j] = min(table[i][j-1], 
-                                 table[i + (1 << (j-1))][j-1]);
+        for (int k = 1; k < levels; k++) {
+            const T* prev = table.data() + (size_t)(k - 1) * n;
+            T* cur = table.data() + (size_t)k * n;
+            int half = 1 << (k - 1);
+            for (int i = 0; i + (1 << k) <= n; i++) {
+                cur[i] = Op::combine(prev[i], prev[i + half]);
             }
         }
-        
-        logTable.resize(n + 1);
-        for (int i = 2; i <= n; i++) {
-            logTable[i] = logTable[i/2] + 1;
-        }
     }
     
-    int query(int l, int r) {
-        int k = logTable[r - l + 1];
-        return min(table[l][k], 
-                  table[r - (1 << k) + 1][k]);
+    T query(int l, int r) const {
+        int k = __lg(r - l + 1);
+        const T* level = table.data() + (size_t)k * n;
+        return Op::combine(level[l], level[r - (1 << k) + 1]);
     }
 };
 
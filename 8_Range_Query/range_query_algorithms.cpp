@@ -1,36 +1,75 @@
 #include <bits/stdc++.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
+// ============================================================================
+// MONOIDS
+// ============================================================================
+
+// A monoid supplies an associative combine() and its identity element.
+// Segment trees below are templated on them, so each instantiation is
+// compiled with the operation inlined.
+
+template <typename T>
+struct SumOp {
+    static T identity() { return T(0); }
+    static T combine(const T& a, const T& b) { return a + b; }
+};
+
+template <typename T>
+struct MinOp {
+    static T identity() { return numeric_limits<T>::max(); }
+    static T combine(const T& a, const T& b) { return min(a, b); }
+};
+
+template <typename T>
+struct MaxOp {
+    static T identity() { return numeric_limits<T>::lowest(); }
+    static T combine(const T& a, const T& b) { return max(a, b); }
+};
+
+template <typename T>
+struct GcdOp {
+    static T identity() { return T(0); }
+    static T combine(const T& a, const T& b) { return gcd(a, b); }
+};
+
 // ============================================================================
 // SEGMENT TREE
 // ============================================================================
 
+template <typename T, typename Op = SumOp<T>>
 class SegmentTree {
 private:
-    vector<int> tree;
+    vector<T> tree;
     int n;
     
-    void build(vector<int>& arr, int node, int start, int end) {
+    void build(const T* arr, int node, int start, int end) {
         if (start == end) {
             tree[node] = arr[start];
         } else {
             int mid = (start + end) / 2;
             build(arr, 2*node, start, mid);
             build(arr, 2*node+1, mid+1, end);
-            tree[node] = tree[2*node] + tree[2*node+1];
+            tree[node] = Op::combine(tree[2*node], tree[2*node+1]);
         }
     }
     
-    int query(int node, int start, int end, int l, int r) {
-        if (r < start || end < l) return 0;
+    T query(int node, int start, int end, int l, int r) const {
+        if (r < start || end < l) return Op::identity();
         if (l <= start && end <= r) return tree[node];
         
         int mid = (start + end) / 2;
-        return query(2*node, start, mid, l, r) + 
-               query(2*node+1, mid+1, end, l, r);
+        return Op::combine(query(2*node, start, mid, l, r),
+                           query(2*node+1, mid+1, end, l, r));
     }
     
-    void update(int node, int start, int end, int idx, int val) {
+    void update(int node, int start, int end, int idx, const T& val) {
         if (start == end) {
             tree[node] = val;
         } else {
@@ -40,300 +79,1930 @@ private:
             } else {
                 update(2*node+1, mid+1, end, idx, val);
             }
-            tree[node] = tree[2*node] + tree[2*node+1];
+            tree[node] = Op::combine(tree[2*node], tree[2*node+1]);
         }
     }
     
 public:
-    SegmentTree(vector<int>& arr) {
-        n = arr.size();
-        tree.resize(4 * n);
-        build(arr, 1, 0, n-1);
+    // Builds over the read-only range [first, last)
+    SegmentTree(const T* first, const T* last) {
+        n = last - first;
+        tree.assign(4 * max(n, 1), Op::identity());
+        if (n > 0) build(first, 1, 0, n-1);
     }
     
-    int rangeSum(int l, int r) {
+    SegmentTree(const vector<T>& arr) : SegmentTree(arr.data(), arr.data() + arr.size()) {}
+    
+    int size() const { return n; }
+    
+    // Combined value over [l, r], identity for an empty range
+    T query(int l, int r) const {
+        if (l > r) return Op::identity();
         return query(1, 0, n-1, l, r);
     }
     
-    void updateElement(int idx, int val) {
+    void updateElement(int idx, const T& val) {
         update(1, 0, n-1, idx, val);
     }
 };
 
+template <typename T> using SumSegmentTree = SegmentTree<T, SumOp<T>>;
+template <typename T> using MinSegmentTree = SegmentTree<T, MinOp<T>>;
+template <typename T> using MaxSegmentTree = SegmentTree<T, MaxOp<T>>;
+template <typename T> using GcdSegmentTree = SegmentTree<T, GcdOp<T>>;
+
+// ============================================================================
+// ITERATIVE (BOTTOM-UP) SEGMENT TREE
+// ============================================================================
+
+// Non-recursive tree of size 2n: leaves live contiguously in tree[n..2n),
+// node i has children 2i and 2i+1. No recursion and no 4n padding.
+template <typename T, typename Op = SumOp<T>>
+class IterativeSegmentTree {
+private:
+    vector<T> tree;
+    int n;
+    
+public:
+    IterativeSegmentTree(const T* first, const T* last) {
+        n = last - first;
+        tree.assign(2 * n, Op::identity());
+        copy(first, last, tree.begin() + n);
+        for (int i = n - 1; i > 0; i--) {
+            tree[i] = Op::combine(tree[2*i], tree[2*i+1]);
+        }
+    }
+    
+    IterativeSegmentTree(const vector<T>& arr)
+        : IterativeSegmentTree(arr.data(), arr.data() + arr.size()) {}
+    
+    int size() const { return n; }
+    
+    // Combined value over [l, r]; left/right accumulators keep the
+    // order of operands, so non-commutative monoids work too
+    T query(int l, int r) const {
+        T resl = Op::identity(), resr = Op::identity();
+        for (l += n, r += n + 1; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) resl = Op::combine(resl, tree[l++]);
+            if (r & 1) resr = Op::combine(tree[--r], resr);
+        }
+        return Op::combine(resl, resr);
+    }
+    
+    void updateElement(int idx, const T& val) {
+        idx += n;
+        tree[idx] = val;
+        for (idx >>= 1; idx > 0; idx >>= 1) {
+            tree[idx] = Op::combine(tree[2*idx], tree[2*idx+1]);
+        }
+    }
+};
+
+// ============================================================================
+// WIDE (B-ARY) SEGMENT TREE
+// ============================================================================
+
+// Every node holds B children packed in one 64-byte cache line, so a query
+// touches one or two lines per level and the tree is only log_B(n) deep.
+// Partial nodes are reduced with a fixed-length masked loop that the
+// compiler turns into SIMD code (build with -O3 -march=native).
+template <typename T, typename Op = SumOp<T>, int B = 64 / sizeof(T)>
+class WideSegmentTree {
+private:
+    struct alignas(64) Node {
+        T v[B];
+    };
+    
+    vector<Node> nodes;         // all levels, leaves first
+    vector<int> levelStart;     // first node of each level
+    vector<int> levelSize;      // number of elements on each level
+    int n;
+    
+    // Reduces lanes [from, to) of a node; always runs B iterations with a
+    // branch-free select (unsigned wrap-around turns the range test into a
+    // single compare), so the loop becomes a vector blend + reduction
+    static T reduceNode(const Node& node, unsigned from, unsigned to) {
+        const T id = Op::identity();
+        T acc = id;
+        for (unsigned j = 0; j < B; j++) {
+            T x = node.v[j];
+            acc = Op::combine(acc, (j - from < to - from) ? x : id);
+        }
+        return acc;
+    }
+    
+    T& at(int level, int i) {
+        return nodes[levelStart[level] + i / B].v[i % B];
+    }
+    
+public:
+    WideSegmentTree(const T* first, const T* last) {
+        n = last - first;
+        int total = 0, len = max(n, 1);
+        while (true) {
+            levelStart.push_back(total);
+            levelSize.push_back(len);
+            total += (len + B - 1) / B;
+            if (len == 1) break;
+            len = (len + B - 1) / B;
+        }
+        
+        Node empty;
+        fill(empty.v, empty.v + B, Op::identity());
+        nodes.assign(total, empty);
+        
+        for (int i = 0; i < n; i++) at(0, i) = first[i];
+        for (int k = 1; k < (int)levelSize.size(); k++) {
+            for (int i = 0; i < levelSize[k]; i++) {
+                at(k, i) = reduceNode(nodes[levelStart[k-1] + i], 0, B);
+            }
+        }
+    }
+    
+    WideSegmentTree(const vector<T>& arr)
+        : WideSegmentTree(arr.data(), arr.data() + arr.size()) {}
+    
+    int size() const { return n; }
+    
+    T query(int l, int r) const {
+        T resl = Op::identity(), resr = Op::identity();
+        int lo = l, hi = r + 1;     // half-open on the current level
+        
+        for (int k = 0; lo < hi; k++) {
+            const Node* level = nodes.data() + levelStart[k];
+            if (lo / B == (hi - 1) / B) {
+                resl = Op::combine(resl, reduceNode(level[lo / B], lo % B, (hi - 1) % B + 1));
+                break;
+            }
+            resl = Op::combine(resl, reduceNode(level[lo / B], lo % B, B));
+            if (hi % B) resr = Op::combine(reduceNode(level[hi / B], 0, hi % B), resr);
+            lo = lo / B + 1;
+            hi = hi / B;
+        }
+        return Op::combine(resl, resr);
+    }
+    
+    void updateElement(int idx, const T& val) {
+        at(0, idx) = val;
+        for (int k = 1; k < (int)levelSize.size(); k++) {
+            idx /= B;
+            at(k, idx) = reduceNode(nodes[levelStart[k-1] + idx], 0, B);
+        }
+    }
+};
+
 // ============================================================================
 // LAZY PROPAGATION SEGMENT TREE
 // ============================================================================
 
+// Sum, min and max of a range carried together, plus its length so that
+// tags which depend on the range size (add, assign) can be applied.
+template <typename V>
+struct RangeStats {
+    V sum, mn, mx;
+    int len;
+    
+    static RangeStats leaf(V x) { return {x, x, x, 1}; }
+};
+
+template <typename V>
+struct StatsOp {
+    static RangeStats<V> identity() {
+        return {V(0), numeric_limits<V>::max(), numeric_limits<V>::lowest(), 0};
+    }
+    static RangeStats<V> combine(const RangeStats<V>& a, const RangeStats<V>& b) {
+        return {a.sum + b.sum, min(a.mn, b.mn), max(a.mx, b.mx), a.len + b.len};
+    }
+};
+
+// Lazy tag x -> a*x + b. Add is (1, v), assign is (0, v).
+// compose(f, g) is "f after g"; apply(f, s) maps a whole range summary.
+template <typename V>
+struct AffineAction {
+    struct Tag {
+        V a, b;
+    };
+    
+    static Tag identity() { return {V(1), V(0)}; }
+    static Tag add(V v) { return {V(1), v}; }
+    static Tag assign(V v) { return {V(0), v}; }
+    static Tag affine(V a, V b) { return {a, b}; }
+    
+    static Tag compose(const Tag& f, const Tag& g) {
+        return {f.a * g.a, f.a * g.b + f.b};
+    }
+    
+    static RangeStats<V> apply(const Tag& f, const RangeStats<V>& s) {
+        if (s.len == 0) return s;
+        V lo = f.a * s.mn + f.b, hi = f.a * s.mx + f.b;
+        if (f.a < V(0)) swap(lo, hi);
+        return {f.a * s.sum + f.b * s.len, lo, hi, s.len};
+    }
+};
+
+// Iterative lazy segment tree over a value monoid Op (values of type T) and
+// a tag action Act (Act::Tag, identity, compose, apply). Leaves sit in
+// d[size..2*size); lz[k] is the tag still owed to the children of node k.
+template <typename T, typename Op, typename Act>
 class LazySegmentTree {
+public:
+    using Tag = typename Act::Tag;
+    
+private:
+    vector<T> d;
+    vector<Tag> lz;
+    vector<int> dirty;      // ancestors awaiting recomputation in a batch
+    int n, size, log;
+    
+    void pull(int k) {
+        d[k] = Op::combine(d[2*k], d[2*k+1]);
+    }
+    
+    void applyNode(int k, const Tag& f) {
+        d[k] = Act::apply(f, d[k]);
+        if (k < size) lz[k] = Act::compose(f, lz[k]);
+    }
+    
+    void push(int k) {
+        applyNode(2*k, lz[k]);
+        applyNode(2*k+1, lz[k]);
+        lz[k] = Act::identity();
+    }
+    
+    // Push pending tags down to the boundary leaves of [l, r)
+    void pushBoundaries(int l, int r) {
+        for (int i = log; i >= 1; i--) {
+            if (((l >> i) << i) != l) push(l >> i);
+            if (((r >> i) << i) != r) push((r - 1) >> i);
+        }
+    }
+    
+    // Tag the O(log n) canonical nodes covering [l, r)
+    void applyCanonical(int l, int r, const Tag& f) {
+        while (l < r) {
+            if (l & 1) applyNode(l++, f);
+            if (r & 1) applyNode(--r, f);
+            l >>= 1;
+            r >>= 1;
+        }
+    }
+    
+public:
+    LazySegmentTree(const vector<T>& values) : n(values.size()) {
+        log = 0;
+        while ((1 << log) < n) log++;
+        size = 1 << log;
+        d.assign(2 * size, Op::identity());
+        lz.assign(size, Act::identity());
+        copy(values.begin(), values.end(), d.begin() + size);
+        for (int k = size - 1; k >= 1; k--) pull(k);
+    }
+    
+    void updateElement(int idx, const T& val) {
+        idx += size;
+        for (int i = log; i >= 1; i--) push(idx >> i);
+        d[idx] = val;
+        for (int i = 1; i <= log; i++) pull(idx >> i);
+    }
+    
+    // Combined value over [l, r]
+    T query(int l, int r) {
+        if (l > r) return Op::identity();
+        l += size;
+        r += size + 1;
+        pushBoundaries(l, r);
+        
+        T resl = Op::identity(), resr = Op::identity();
+        while (l < r) {
+            if (l & 1) resl = Op::combine(resl, d[l++]);
+            if (r & 1) resr = Op::combine(d[--r], resr);
+            l >>= 1;
+            r >>= 1;
+        }
+        return Op::combine(resl, resr);
+    }
+    
+    // Applies tag f to every element in [l, r]
+    void updateRange(int l, int r, const Tag& f) {
+        if (l > r) return;
+        l += size;
+        r += size + 1;
+        pushBoundaries(l, r);
+        applyCanonical(l, r, f);
+        for (int i = 1; i <= log; i++) {
+            if (((l >> i) << i) != l) pull(l >> i);
+            if (((r >> i) << i) != r) pull((r - 1) >> i);
+        }
+    }
+    
+    // Applies many range tags in order. Ancestors are not recomputed per
+    // update; every touched ancestor is recomputed once at the end, so
+    // updates sharing the upper levels of the tree share that work.
+    void updateBatch(const vector<tuple<int, int, Tag>>& updates) {
+        dirty.clear();
+        for (auto& [ql, qr, f] : updates) {
+            if (ql > qr) continue;
+            int l = ql + size, r = qr + size + 1;
+            pushBoundaries(l, r);
+            applyCanonical(l, r, f);
+            for (int i = 1; i <= log; i++) {
+                dirty.push_back(l >> i);
+                dirty.push_back((r - 1) >> i);
+            }
+        }
+        
+        // Children have larger indices than parents, so descending order
+        // rebuilds bottom-up. A dirty node may have received a tag as a
+        // canonical node meanwhile, hence apply(lz, ...) instead of pull.
+        sort(dirty.begin(), dirty.end(), greater<int>());
+        dirty.erase(unique(dirty.begin(), dirty.end()), dirty.end());
+        for (int k : dirty) {
+            d[k] = Act::apply(lz[k], Op::combine(d[2*k], d[2*k+1]));
+        }
+    }
+};
+
+template <typename V>
+using AffineSegmentTree = LazySegmentTree<RangeStats<V>, StatsOp<V>, AffineAction<V>>;
+
+// ============================================================================
+// SEGMENT TREE BEATS
+// ============================================================================
+
+// Range chmin / chmax / add with range sum / min / max queries.
+// Each node tracks its maximum, strict second maximum and the count of
+// the maximum (and the same for the minimum): a chmin with
+// second max < x <= max only touches the maximum elements, so it is
+// applied as a tag; otherwise the update recurses further.
+// Amortized O(log^2 n) per operation.
+class SegmentTreeBeats {
 private:
-    vector<int> tree, lazy;
+    static constexpr long long INF = LLONG_MAX / 4;
+    
+    struct Node {
+        long long sum, max1, max2, min1, min2, add;
+        int maxc, minc;
+    };
+    
+    vector<Node> tree;
     int n;
     
+    void pull(int node) {
+        Node& t = tree[node];
+        const Node& a = tree[2*node];
+        const Node& b = tree[2*node+1];
+        t.sum = a.sum + b.sum;
+        
+        if (a.max1 == b.max1) {
+            t.max1 = a.max1;
+            t.maxc = a.maxc + b.maxc;
+            t.max2 = max(a.max2, b.max2);
+        } else if (a.max1 > b.max1) {
+            t.max1 = a.max1;
+            t.maxc = a.maxc;
+            t.max2 = max(a.max2, b.max1);
+        } else {
+            t.max1 = b.max1;
+            t.maxc = b.maxc;
+            t.max2 = max(a.max1, b.max2);
+        }
+        
+        if (a.min1 == b.min1) {
+            t.min1 = a.min1;
+            t.minc = a.minc + b.minc;
+            t.min2 = min(a.min2, b.min2);
+        } else if (a.min1 < b.min1) {
+            t.min1 = a.min1;
+            t.minc = a.minc;
+            t.min2 = min(a.min2, b.min1);
+        } else {
+            t.min1 = b.min1;
+            t.minc = b.minc;
+            t.min2 = min(a.min1, b.min2);
+        }
+    }
+    
+    void applyAdd(int node, int len, long long v) {
+        Node& t = tree[node];
+        t.sum += v * len;
+        t.max1 += v;
+        t.min1 += v;
+        if (t.max2 != -INF) t.max2 += v;
+        if (t.min2 != INF) t.min2 += v;
+        t.add += v;
+    }
+    
+    // Lowers the maximum elements to v; requires max2 < v
+    void applyChmin(int node, long long v) {
+        Node& t = tree[node];
+        if (v >= t.max1) return;
+        t.sum -= (t.max1 - v) * t.maxc;
+        if (t.max1 == t.min1) t.min1 = v;
+        else if (t.max1 == t.min2) t.min2 = v;
+        t.max1 = v;
+    }
+    
+    // Raises the minimum elements to v; requires min2 > v
+    void applyChmax(int node, long long v) {
+        Node& t = tree[node];
+        if (v <= t.min1) return;
+        t.sum += (v - t.min1) * t.minc;
+        if (t.min1 == t.max1) t.max1 = v;
+        else if (t.min1 == t.max2) t.max2 = v;
+        t.min1 = v;
+    }
+    
     void push(int node, int start, int end) {
-        if (lazy[node] != 0) {
-            tree[node] += (end - start + 1) * lazy[node];
-            if (start != end) {
-                lazy[2*node] += lazy[node];
-                lazy[2*node+1] += lazy[node];
-            }
-            lazy[node] = 0;
+        int mid = (start + end) / 2;
+        if (tree[node].add != 0) {
+            applyAdd(2*node, mid - start + 1, tree[node].add);
+            applyAdd(2*node+1, end - mid, tree[node].add);
+            tree[node].add = 0;
         }
+        // Children whose extremes exceed the parent's were clamped
+        applyChmin(2*node, tree[node].max1);
+        applyChmin(2*node+1, tree[node].max1);
+        applyChmax(2*node, tree[node].min1);
+        applyChmax(2*node+1, tree[node].min1);
     }
     
-    void build(vector<int>& arr, int node, int start, int end) {
+    void build(const vector<long long>& arr, int node, int start, int end) {
+        tree[node].add = 0;
         if (start == end) {
-            tree[node] = arr[start];
-        } else {
-            int mid = (start + end) / 2;
-            build(arr, 2*node, start, mid);
-            build(arr, 2*node+1, mid+1, end);
-            tree[node] = tree[2*node] + tree[2*node+1];
+            long long v = arr[start];
+            tree[node] = {v, v, -INF, v, INF, 0, 1, 1};
+            return;
+        }
+        int mid = (start + end) / 2;
+        build(arr, 2*node, start, mid);
+        build(arr, 2*node+1, mid+1, end);
+        pull(node);
+    }
+    
+    void chmin(int node, int start, int end, int l, int r, long long v) {
+        if (r < start || end < l || tree[node].max1 <= v) return;
+        if (l <= start && end <= r && tree[node].max2 < v) {
+            applyChmin(node, v);
+            return;
         }
+        push(node, start, end);
+        int mid = (start + end) / 2;
+        chmin(2*node, start, mid, l, r, v);
+        chmin(2*node+1, mid+1, end, l, r, v);
+        pull(node);
     }
     
-    void updateRange(int node, int start, int end, int l, int r, int val) {
+    void chmax(int node, int start, int end, int l, int r, long long v) {
+        if (r < start || end < l || tree[node].min1 >= v) return;
+        if (l <= start && end <= r && tree[node].min2 > v) {
+            applyChmax(node, v);
+            return;
+        }
         push(node, start, end);
-        if (start > r || end < l) return;
+        int mid = (start + end) / 2;
+        chmax(2*node, start, mid, l, r, v);
+        chmax(2*node+1, mid+1, end, l, r, v);
+        pull(node);
+    }
+    
+    void add(int node, int start, int end, int l, int r, long long v) {
+        if (r < start || end < l) return;
         if (l <= start && end <= r) {
-            lazy[node] += val;
-            push(node, start, end);
+            applyAdd(node, end - start + 1, v);
             return;
         }
-        
+        push(node, start, end);
         int mid = (start + end) / 2;
-        updateRange(2*node, start, mid, l, r, val);
-        updateRange(2*node+1, mid+1, end, l, r, val);
-        push(2*node, start, mid);
-        push(2*node+1, mid+1, end);
-        tree[node] = tree[2*node] + tree[2*node+1];
+        add(2*node, start, mid, l, r, v);
+        add(2*node+1, mid+1, end, l, r, v);
+        pull(node);
     }
     
-    int query(int node, int start, int end, int l, int r) {
+    // Folds f over the nodes covering [l, r]
+    template <typename Fn>
+    void visit(int node, int start, int end, int l, int r, Fn& f) {
+        if (r < start || end < l) return;
+        if (l <= start && end <= r) {
+            f(tree[node]);
+            return;
+        }
         push(node, start, end);
-        if (start > r || end < l) return 0;
-        if (l <= start && end <= r) return tree[node];
+        int mid = (start + end) / 2;
+        visit(2*node, start, mid, l, r, f);
+        visit(2*node+1, mid+1, end, l, r, f);
+    }
+    
+public:
+    SegmentTreeBeats(const vector<long long>& arr) : n(arr.size()) {
+        tree.resize(4 * max(n, 1));
+        if (n > 0) build(arr, 1, 0, n-1);
+    }
+    
+    // a[i] = min(a[i], v) for i in [l, r]
+    void chmin(int l, int r, long long v) { chmin(1, 0, n-1, l, r, v); }
+    
+    // a[i] = max(a[i], v) for i in [l, r]
+    void chmax(int l, int r, long long v) { chmax(1, 0, n-1, l, r, v); }
+    
+    void rangeAdd(int l, int r, long long v) { add(1, 0, n-1, l, r, v); }
+    
+    long long rangeSum(int l, int r) {
+        long long res = 0;
+        auto f = [&](const Node& t) { res += t.sum; };
+        visit(1, 0, n-1, l, r, f);
+        return res;
+    }
+    
+    long long rangeMin(int l, int r) {
+        long long res = INF;
+        auto f = [&](const Node& t) { res = min(res, t.min1); };
+        visit(1, 0, n-1, l, r, f);
+        return res;
+    }
+    
+    long long rangeMax(int l, int r) {
+        long long res = -INF;
+        auto f = [&](const Node& t) { res = max(res, t.max1); };
+        visit(1, 0, n-1, l, r, f);
+        return res;
+    }
+};
+
+// ============================================================================
+// PERSISTENT SEGMENT TREE
+// ============================================================================
+
+// Path-copying sum tree: every update copies the O(log n) nodes on its
+// root-to-leaf path into a shared node pool and yields a new version,
+// while all older versions stay queryable. Node 0 is a shared all-zero
+// node, so an empty version costs no memory.
+template <typename T>
+class PersistentSegmentTree {
+private:
+    struct Node {
+        int left, right;
+        T sum;
+    };
+    
+    vector<Node> pool;
+    vector<int> roots;          // root node of each version
+    vector<int> created;        // nodes allocated by each version
+    int n;
+    
+    int newNode(const Node& node) {
+        pool.push_back(node);
+        return pool.size() - 1;
+    }
+    
+    int build(const vector<T>& arr, int start, int end) {
+        if (start == end) return newNode({0, 0, arr[start]});
+        int mid = (start + end) / 2;
+        int l = build(arr, start, mid);
+        int r = build(arr, mid+1, end);
+        return newNode({l, r, pool[l].sum + pool[r].sum});
+    }
+    
+    T query(int node, int start, int end, int l, int r) const {
+        if (node == 0 || r < start || end < l) return T(0);
+        if (l <= start && end <= r) return pool[node].sum;
         
         int mid = (start + end) / 2;
-        return query(2*node, start, mid, l, r) + 
-               query(2*node+1, mid+1, end, l, r);
+        return query(pool[node].left, start, mid, l, r) +
+               query(pool[node].right, mid+1, end, l, r);
+    }
+    
+    int addVersion(int root, size_t before) {
+        roots.push_back(root);
+        created.push_back(pool.size() - before);
+        return roots.size() - 1;
+    }
+    
+public:
+    // Version 0 is all zeros
+    PersistentSegmentTree(int n, int expectedUpdates = 0) : n(n) {
+        pool.reserve(1 + (size_t)expectedUpdates * (__lg(max(n, 1)) + 2));
+        pool.push_back({0, 0, T(0)});
+        addVersion(0, pool.size());
+    }
+    
+    // Version 0 holds arr
+    PersistentSegmentTree(const vector<T>& arr, int expectedUpdates = 0)
+        : PersistentSegmentTree(arr.size(), expectedUpdates) {
+        pool.reserve(pool.capacity() + 2 * arr.size());
+        size_t before = pool.size();
+        roots[0] = arr.empty() ? 0 : build(arr, 0, n-1);
+        created[0] = pool.size() - before;
+    }
+    
+    // New version equal to `version` with arr[idx] += delta - O(log n)
+    int add(int version, int idx, T delta) {
+        size_t before = pool.size();
+        int root = newNode(pool[roots[version]]);
+        int node = root, start = 0, end = n-1;
+        
+        while (true) {
+            pool[node].sum += delta;
+            if (start == end) break;
+            int mid = (start + end) / 2;
+            
+            // Copy the child on the path and relink the fresh parent to it
+            if (idx <= mid) {
+                int child = newNode(pool[pool[node].left]);
+                pool[node].left = child;
+                node = child;
+                end = mid;
+            } else {
+                int child = newNode(pool[pool[node].right]);
+                pool[node].right = child;
+                node = child;
+                start = mid + 1;
+            }
+        }
+        return addVersion(root, before);
+    }
+    
+    // New version equal to `version` with arr[idx] = val - O(log n)
+    int updateElement(int version, int idx, T val) {
+        return add(version, idx, val - query(version, idx, idx));
+    }
+    
+    T query(int version, int l, int r) const {
+        if (l > r) return T(0);
+        return query(roots[version], 0, n-1, l, r);
+    }
+    
+    // Smallest idx with sum over [0, idx] of (hi - lo) >= k, where hi and lo
+    // are versions and every element of hi - lo is non-negative
+    int kthIndex(int loVersion, int hiVersion, T k) const {
+        int lo = roots[loVersion], hi = roots[hiVersion];
+        int start = 0, end = n-1;
+        while (start < end) {
+            int mid = (start + end) / 2;
+            T leftCount = pool[pool[hi].left].sum - pool[pool[lo].left].sum;
+            if (k <= leftCount) {
+                lo = pool[lo].left;
+                hi = pool[hi].left;
+                end = mid;
+            } else {
+                k -= leftCount;
+                lo = pool[lo].right;
+                hi = pool[hi].right;
+                start = mid + 1;
+            }
+        }
+        return start;
+    }
+    
+    int versions() const { return roots.size(); }
+    
+    // Bytes of nodes allocated when `version` was created
+    size_t memoryUsage(int version) const {
+        return created[version] * sizeof(Node);
+    }
+    
+    size_t totalMemory() const {
+        return pool.size() * sizeof(Node);
+    }
+};
+
+// k-th smallest value in arr[l..r] in O(log n): version i of a persistent
+// count tree over value ranks holds the first i elements, so counts of
+// arr[l..r] are the difference of versions r+1 and l.
+template <typename T>
+class RangeKthSmallest {
+private:
+    vector<T> values;                   // sorted distinct values
+    PersistentSegmentTree<int> counts;
+    vector<int> prefixVersion;
+    
+    static vector<T> distinctSorted(vector<T> arr) {
+        sort(arr.begin(), arr.end());
+        arr.erase(unique(arr.begin(), arr.end()), arr.end());
+        return arr;
+    }
+    
+public:
+    RangeKthSmallest(const vector<T>& arr)
+        : values(distinctSorted(arr)), counts(max((int)values.size(), 1), arr.size()) {
+        prefixVersion.push_back(0);
+        for (const T& x : arr) {
+            int rank = lower_bound(values.begin(), values.end(), x) - values.begin();
+            prefixVersion.push_back(counts.add(prefixVersion.back(), rank, 1));
+        }
+    }
+    
+    // k-th smallest in arr[l..r]; k is 0-based like the indices, so k = 0
+    // gives the minimum (same convention as WaveletMatrix::kthSmallest)
+    T kth(int l, int r, int k) const {
+        return values[counts.kthIndex(prefixVersion[l], prefixVersion[r + 1], k + 1)];
+    }
+};
+
+// ============================================================================
+// FENWICK TREE
+// ============================================================================
+
+template <typename T>
+class FenwickTree {
+private:
+    vector<T> tree;
+    vector<T> vals;     // shadow copy of the array for O(1) point reads
+    int n;
+    
+    T query(int idx) const {
+        T sum = T(0);
+        while (idx > 0) {
+            sum += tree[idx];
+            idx -= idx & -idx;
+        }
+        return sum;
+    }
+    
+public:
+    FenwickTree(int n) : tree(n + 1, T(0)), vals(n, T(0)), n(n) {}
+    
+    // O(n) build: each node pushes its total to its parent once
+    FenwickTree(const vector<T>& arr) : tree(arr.size() + 1, T(0)), vals(arr), n(arr.size()) {
+        for (int i = 1; i <= n; i++) {
+            tree[i] += arr[i - 1];
+            int parent = i + (i & -i);
+            if (parent <= n) tree[parent] += tree[i];
+        }
+    }
+    
+    int size() const { return n; }
+    
+    void add(int idx, T delta) {
+        vals[idx] += delta;
+        for (idx++; idx <= n; idx += idx & -idx) {
+            tree[idx] += delta;
+        }
+    }
+    
+    void updateElement(int idx, T val) {
+        add(idx, val - vals[idx]);
+    }
+    
+    T get(int idx) const {
+        return vals[idx];
+    }
+    
+    // Sum of [0, idx]
+    T prefixSum(int idx) const {
+        return query(idx + 1);
+    }
+    
+    T rangeSum(int l, int r) const {
+        if (l > r) return T(0);
+        return query(r + 1) - query(l);
+    }
+    
+    // Smallest idx with prefixSum(idx) >= target, or n if none.
+    // Binary lifting over the tree - requires non-negative elements.
+    int lowerBound(T target) const {
+        if (target <= T(0)) return 0;
+        int pos = 0;
+        for (int step = n ? 1 << __lg(n) : 0; step > 0; step >>= 1) {
+            if (pos + step <= n && tree[pos + step] < target) {
+                pos += step;
+                target -= tree[pos];
+            }
+        }
+        return pos;
+    }
+};
+
+// Range add + range sum with two Fenwick trees:
+// prefixSum(i) = (i + 1) * sum(d[0..i]) - sum(d[j] * j, j <= i)
+// where d is the difference array of the values.
+template <typename T>
+class RangeFenwickTree {
+private:
+    FenwickTree<T> d, dj;
+    
+    T prefixSum(int idx) const {
+        if (idx < 0) return T(0);
+        return T(idx + 1) * d.prefixSum(idx) - dj.prefixSum(idx);
+    }
+    
+    void addDiff(int idx, T delta) {
+        if (idx >= d.size()) return;
+        d.add(idx, delta);
+        dj.add(idx, delta * T(idx));
+    }
+    
+    static vector<T> diff(const vector<T>& arr, bool weighted) {
+        vector<T> res(arr.size());
+        for (int i = 0; i < (int)arr.size(); i++) {
+            res[i] = arr[i] - (i ? arr[i - 1] : T(0));
+            if (weighted) res[i] *= T(i);
+        }
+        return res;
+    }
+    
+public:
+    RangeFenwickTree(int n) : d(n), dj(n) {}
+    RangeFenwickTree(const vector<T>& arr) : d(diff(arr, false)), dj(diff(arr, true)) {}
+    
+    // Adds val to every element of [l, r]
+    void rangeAdd(int l, int r, T val) {
+        if (l > r) return;
+        addDiff(l, val);
+        addDiff(r + 1, -val);
+    }
+    
+    T rangeSum(int l, int r) const {
+        return prefixSum(r) - prefixSum(l - 1);
+    }
+    
+    T get(int idx) const {
+        return d.prefixSum(idx);
+    }
+};
+
+// 2D Fenwick tree for point add / rectangle sum on a rows x cols grid,
+// stored flat (row-major) for locality
+template <typename T>
+class FenwickTree2D {
+private:
+    vector<T> tree;
+    int rows, cols;
+    
+    T& at(int i, int j) { return tree[(size_t)i * (cols + 1) + j]; }
+    T at(int i, int j) const { return tree[(size_t)i * (cols + 1) + j]; }
+    
+    T query(int r, int c) const {
+        T sum = T(0);
+        for (int i = r; i > 0; i -= i & -i) {
+            for (int j = c; j > 0; j -= j & -j) {
+                sum += at(i, j);
+            }
+        }
+        return sum;
+    }
+    
+public:
+    FenwickTree2D(int rows, int cols)
+        : tree((size_t)(rows + 1) * (cols + 1), T(0)), rows(rows), cols(cols) {}
+    
+    // O(rows * cols) build, rows then columns pushed to their parents
+    FenwickTree2D(const vector<vector<T>>& grid)
+        : FenwickTree2D(grid.size(), grid.empty() ? 0 : grid[0].size()) {
+        for (int i = 1; i <= rows; i++) {
+            for (int j = 1; j <= cols; j++) {
+                at(i, j) += grid[i - 1][j - 1];
+                int pj = j + (j & -j);
+                if (pj <= cols) at(i, pj) += at(i, j);
+            }
+        }
+        for (int i = 1; i <= rows; i++) {
+            int pi = i + (i & -i);
+            if (pi > rows) continue;
+            for (int j = 1; j <= cols; j++) {
+                at(pi, j) += at(i, j);
+            }
+        }
+    }
+    
+    void add(int r, int c, T delta) {
+        for (int i = r + 1; i <= rows; i += i & -i) {
+            for (int j = c + 1; j <= cols; j += j & -j) {
+                at(i, j) += delta;
+            }
+        }
+    }
+    
+    // Sum over rows [r1, r2] x cols [c1, c2]
+    T rectSum(int r1, int c1, int r2, int c2) const {
+        if (r1 > r2 || c1 > c2) return T(0);
+        return query(r2 + 1, c2 + 1) - query(r1, c2 + 1)
+             - query(r2 + 1, c1) + query(r1, c1);
+    }
+};
+
+// ============================================================================
+// 2D RANGE QUERIES ON SPARSE GRIDS
+// ============================================================================
+
+// 2D Fenwick tree over compressed coordinates: only the points that will
+// ever be updated are registered up front, and every x-node keeps a
+// Fenwick tree over just the y's that reach it. O(P log P) memory for P
+// points instead of O(X * Y); add and rectSum are O(log^2 P).
+// All per-node trees share one flat array.
+template <typename C, typename T>
+class CompressedFenwick2D {
+private:
+    vector<C> xs;               // sorted distinct x
+    vector<int> start;          // node i owns ys/tree [start[i], start[i+1])
+    vector<C> ys;
+    vector<T> tree;
+    
+    // Sum over registered points with x-rank < xr and y <= bound (y < bound
+    // if strict). The strict form keeps lower bounds exact for any C.
+    T prefix(int xr, C bound, bool strict = false) const {
+        T sum = T(0);
+        for (int i = xr; i > 0; i -= i & -i) {
+            auto first = ys.begin() + start[i], last = ys.begin() + start[i + 1];
+            int j = (strict ? lower_bound(first, last, bound) : upper_bound(first, last, bound)) - first;
+            for (; j > 0; j -= j & -j) sum += tree[start[i] + j - 1];
+        }
+        return sum;
+    }
+    
+    int xRankAtMost(C x) const {
+        return upper_bound(xs.begin(), xs.end(), x) - xs.begin();
+    }
+    
+public:
+    CompressedFenwick2D(const vector<pair<C, C>>& points) {
+        for (auto& p : points) xs.push_back(p.first);
+        sort(xs.begin(), xs.end());
+        xs.erase(unique(xs.begin(), xs.end()), xs.end());
+        int X = xs.size();
+        
+        vector<pair<int, C>> owned;     // (node, y)
+        for (auto& [x, y] : points) {
+            int xr = lower_bound(xs.begin(), xs.end(), x) - xs.begin() + 1;
+            for (int i = xr; i <= X; i += i & -i) owned.push_back({i, y});
+        }
+        sort(owned.begin(), owned.end());
+        owned.erase(unique(owned.begin(), owned.end()), owned.end());
+        
+        start.assign(X + 2, 0);
+        for (auto& [i, y] : owned) start[i + 1]++;
+        partial_sum(start.begin(), start.end(), start.begin());
+        ys.resize(owned.size());
+        for (size_t k = 0; k < owned.size(); k++) ys[k] = owned[k].second;
+        tree.assign(owned.size(), T(0));
+    }
+    
+    // (x, y) must be one of the registered points
+    void add(C x, C y, T delta) {
+        int xr = lower_bound(xs.begin(), xs.end(), x) - xs.begin() + 1;
+        assert(xr <= (int)xs.size() && xs[xr - 1] == x);
+        for (int i = xr; i < (int)start.size() - 1; i += i & -i) {
+            auto first = ys.begin() + start[i], last = ys.begin() + start[i + 1];
+            int len = last - first;
+            int j = lower_bound(first, last, y) - first + 1;
+            assert(j <= len && first[j - 1] == y);
+            for (; j <= len; j += j & -j) tree[start[i] + j - 1] += delta;
+        }
+    }
+    
+    // Sum over x in [x1, x2], y in [y1, y2]
+    T rectSum(C x1, C y1, C x2, C y2) const {
+        if (x1 > x2 || y1 > y2) return T(0);
+        int hi = xRankAtMost(x2);
+        int lo = lower_bound(xs.begin(), xs.end(), x1) - xs.begin();
+        return prefix(hi, y2) - prefix(lo, y2) - prefix(hi, y1, true) + prefix(lo, y1, true);
+    }
+};
+
+// Offline sweep: sum of point weights inside each rectangle, for a static
+// point set. Every rectangle becomes two prefix events at x2 and just
+// before x1; sweeping x adds points to a Fenwick tree over compressed y.
+// O((P + Q) log P) for the whole batch.
+template <typename C, typename T>
+vector<T> rectangleSumsOffline(const vector<tuple<C, C, T>>& points,
+                               const vector<array<C, 4>>& rects) {   // {x1, y1, x2, y2}
+    vector<C> ys;
+    for (auto& [x, y, w] : points) ys.push_back(y);
+    sort(ys.begin(), ys.end());
+    ys.erase(unique(ys.begin(), ys.end()), ys.end());
+    
+    vector<int> byX(points.size());
+    iota(byX.begin(), byX.end(), 0);
+    sort(byX.begin(), byX.end(), [&](int a, int b) {
+        return get<0>(points[a]) < get<0>(points[b]);
+    });
+    
+    // {x, rectangle, sign}: rectangle counts points with x' <= x, times sign
+    struct Event {
+        C x;
+        int rect, sign;
+    };
+    vector<Event> events;
+    events.reserve(2 * rects.size());
+    for (int i = 0; i < (int)rects.size(); i++) {
+        if (rects[i][0] > rects[i][2] || rects[i][1] > rects[i][3]) continue;
+        events.push_back({rects[i][2], i, +1});
+        events.push_back({rects[i][0], i, -1});
+    }
+    // A -1 event at x1 must see only points strictly left of x1
+    sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        if (a.x != b.x) return a.x < b.x;
+        return a.sign < b.sign;
+    });
+    
+    FenwickTree<T> fenwick(ys.size());
+    vector<T> results(rects.size(), T(0));
+    size_t next = 0;
+    for (auto& ev : events) {
+        while (next < byX.size()) {
+            auto& [x, y, w] = points[byX[next]];
+            if (ev.sign < 0 ? !(x < ev.x) : ev.x < x) break;
+            fenwick.add(lower_bound(ys.begin(), ys.end(), y) - ys.begin(), w);
+            next++;
+        }
+        const auto& r = rects[ev.rect];
+        int lo = lower_bound(ys.begin(), ys.end(), r[1]) - ys.begin();
+        int hi = upper_bound(ys.begin(), ys.end(), r[3]) - ys.begin() - 1;
+        T inside = fenwick.rangeSum(lo, hi);
+        results[ev.rect] += ev.sign > 0 ? inside : -inside;
+    }
+    return results;
+}
+
+// ============================================================================
+// SPARSE TABLE
+// ============================================================================
+
+// O(1) queries for idempotent monoids (min, max, gcd, and, or).
+// Levels are stored one after another in a single flat array:
+// table[k * n + i] covers [i, i + 2^k), so each level is a contiguous scan.
+template <typename T, typename Op = MinOp<T>>
+class SparseTable {
+private:
+    vector<T> table;
+    int n, levels;
+    
+public:
+    SparseTable(const T* first, const T* last) {
+        n = last - first;
+        levels = n ? __lg(n) + 1 : 0;
+        table.resize((size_t)n * levels);
+        copy(first, last, table.begin());
+        
+        for (int k = 1; k < levels; k++) {
+            const T* prev = table.data() + (size_t)(k - 1) * n;
+            T* cur = table.data() + (size_t)k * n;
+            int half = 1 << (k - 1);
+            for (int i = 0; i + (1 << k) <= n; i++) {
+                cur[i] = Op::combine(prev[i], prev[i + half]);
+            }
+        }
+    }
+    
+    SparseTable(const vector<T>& arr) : SparseTable(arr.data(), arr.data() + arr.size()) {}
+    
+    T query(int l, int r) const {
+        int k = __lg(r - l + 1);
+        const T* level = table.data() + (size_t)k * n;
+        return Op::combine(level[l], level[r - (1 << k) + 1]);
+    }
+};
+
+// ============================================================================
+// BLOCK RMQ (LINEAR MEMORY)
+// ============================================================================
+
+// O(n) preprocessing and memory, O(1) query range minimum.
+// The array is cut into blocks of 32: a sparse table over block minima
+// answers the whole blocks in the middle, and for in-block ranges
+// mask[i] marks the indices of the block that are a minimum of some
+// range ending at i (a monotonic stack as a bitmask), so the answer
+// for [l, i] is its lowest set bit at or after l.
+// Ties resolve to the leftmost index.
+template <typename T, typename Compare = less<T>>
+class BlockRMQ {
+private:
+    static constexpr int B = 32;
+    
+    vector<T> a;
+    vector<uint32_t> mask;
+    vector<int> sparse;         // flat level-major table of block-min indices
+    int n, blocks, levels;
+    Compare cmp;
+    
+    int better(int i, int j) const {
+        return cmp(a[j], a[i]) ? j : i;
+    }
+    
+    int inBlock(int l, int r) const {
+        uint32_t m = mask[r] & (~0u << (l % B));
+        return (l / B) * B + __builtin_ctz(m);
+    }
+    
+    int blockRange(int bl, int br) const {
+        int k = __lg(br - bl + 1);
+        const int* level = sparse.data() + (size_t)k * blocks;
+        return better(level[bl], level[br - (1 << k) + 1]);
+    }
+    
+public:
+    BlockRMQ(const vector<T>& arr, Compare cmp = Compare())
+        : a(arr), mask(arr.size()), n(arr.size()), cmp(cmp) {
+        blocks = (n + B - 1) / B;
+        levels = blocks ? __lg(blocks) + 1 : 0;
+        sparse.resize((size_t)blocks * levels);
+        
+        for (int b = 0; b < blocks; b++) {
+            int start = b * B, end = min(n, start + B);
+            uint32_t cur = 0;
+            for (int i = start; i < end; i++) {
+                while (cur && cmp(a[i], a[start + 31 - __builtin_clz(cur)])) {
+                    cur &= ~(1u << (31 - __builtin_clz(cur)));
+                }
+                cur |= 1u << (i - start);
+                mask[i] = cur;
+            }
+            sparse[b] = inBlock(start, end - 1);
+        }
+        
+        for (int k = 1; k < levels; k++) {
+            const int* prev = sparse.data() + (size_t)(k - 1) * blocks;
+            int* level = sparse.data() + (size_t)k * blocks;
+            int half = 1 << (k - 1);
+            for (int b = 0; b + (1 << k) <= blocks; b++) {
+                level[b] = better(prev[b], prev[b + half]);
+            }
+        }
+    }
+    
+    // Index of the minimum in [l, r]
+    int queryIndex(int l, int r) const {
+        int bl = l / B, br = r / B;
+        if (bl == br) return inBlock(l, r);
+        
+        int res = inBlock(l, bl * B + B - 1);
+        if (bl + 1 < br) res = better(res, blockRange(bl + 1, br - 1));
+        return better(res, inBlock(br * B, r));
+    }
+    
+    T query(int l, int r) const {
+        return a[queryIndex(l, r)];
+    }
+};
+
+// ============================================================================
+// WAVELET MATRIX
+// ============================================================================
+
+// Static bitvector with O(1) rank and O(log n) select. Cumulative
+// popcounts are stored once per 256 bits, so the overhead is 12.5%.
+class BitVector {
+private:
+    vector<uint64_t> words;
+    vector<uint32_t> blockRank;     // ones before each 4-word block
+    int n;
+    
+public:
+    BitVector(int n = 0) : words((n + 63) / 64 + 1, 0), n(n) {}
+    
+    void set(int i) { words[i >> 6] |= 1ULL << (i & 63); }
+    bool get(int i) const { return words[i >> 6] >> (i & 63) & 1; }
+    int size() const { return n; }
+    
+    // Call once after all set() calls
+    void build() {
+        blockRank.assign(words.size() / 4 + 2, 0);
+        uint32_t ones = 0;
+        for (int w = 0; w < (int)words.size(); w++) {
+            if (w % 4 == 0) blockRank[w / 4] = ones;
+            ones += __builtin_popcountll(words[w]);
+        }
+        blockRank.back() = ones;
+    }
+    
+    // Ones in [0, i)
+    int rank1(int i) const {
+        int w = i >> 6, res = blockRank[w >> 2];
+        for (int k = w & ~3; k < w; k++) res += __builtin_popcountll(words[k]);
+        return res + __builtin_popcountll(words[w] & ((1ULL << (i & 63)) - 1));
+    }
+    
+    int rank0(int i) const { return i - rank1(i); }
+    
+    // Position of the k-th (0-based) one / zero, or -1 if there is none
+    int select1(int k) const { return select(k, true); }
+    int select0(int k) const { return select(k, false); }
+    
+    size_t memoryBytes() const {
+        return words.size() * sizeof(uint64_t) + blockRank.size() * sizeof(uint32_t);
+    }
+    
+private:
+    int select(int k, bool one) const {
+        if (k < 0) return -1;
+        auto count = [&](int block) {           // ones or zeros before block
+            return one ? (int)blockRank[block] : block * 256 - (int)blockRank[block];
+        };
+        
+        // Last block with at most k matching bits before it
+        int lo = 0, hi = (words.size() + 3) / 4;
+        while (hi - lo > 1) {
+            int mid = (lo + hi) / 2;
+            if (count(mid) <= k) lo = mid;
+            else hi = mid;
+        }
+        
+        k -= count(lo);
+        for (int w = lo * 4; w < (int)words.size() && w * 64 < n; w++) {
+            uint64_t bits = one ? words[w] : ~words[w];
+            int c = __builtin_popcountll(bits);
+            if (k < c) {
+                for (; k > 0; k--) bits &= bits - 1;    // drop lowest set bits
+                int pos = w * 64 + __builtin_ctzll(bits);
+                return pos < n ? pos : -1;
+            }
+            k -= c;
+        }
+        return -1;
+    }
+};
+
+// Wavelet matrix over the ranks of arr's values: one bitvector per bit of
+// the rank, each level stably partitioned by that bit (zeros first).
+// Uses about n * ceil(log2 sigma) bits; every query is O(log sigma).
+// Public ranges are inclusive [l, r] like the rest of this file.
+template <typename T>
+class WaveletMatrix {
+private:
+    vector<T> values;           // sorted distinct values (rank -> value)
+    vector<BitVector> levels;   // levels[0] holds the highest bit
+    vector<int> zeros;          // zeros on each level
+    int n, bits;
+    
+    int bitOf(int rank, int level) const {
+        return rank >> (bits - 1 - level) & 1;
+    }
+    
+    // Number of elements in [l, r) with rank < upper
+    int countLessRank(int l, int r, int upper) const {
+        if (upper >= (1 << bits)) return r - l;
+        int res = 0;
+        for (int lev = 0; lev < bits; lev++) {
+            int ol = levels[lev].rank1(l), orr = levels[lev].rank1(r);
+            if (bitOf(upper, lev)) {
+                res += (r - l) - (orr - ol);
+                l = zeros[lev] + ol;
+                r = zeros[lev] + orr;
+            } else {
+                l -= ol;
+                r -= orr;
+            }
+        }
+        return res;
+    }
+    
+public:
+    WaveletMatrix(const vector<T>& arr) : values(arr), n(arr.size()) {
+        sort(values.begin(), values.end());
+        values.erase(unique(values.begin(), values.end()), values.end());
+        bits = 1;
+        while ((1 << bits) < (int)values.size()) bits++;
+        
+        vector<int> cur(n), next(n);
+        for (int i = 0; i < n; i++) {
+            cur[i] = lower_bound(values.begin(), values.end(), arr[i]) - values.begin();
+        }
+        
+        levels.assign(bits, BitVector(n));
+        zeros.assign(bits, 0);
+        for (int lev = 0; lev < bits; lev++) {
+            int z = 0;
+            for (int i = 0; i < n; i++) {
+                if (bitOf(cur[i], lev)) levels[lev].set(i);
+                else z++;
+            }
+            levels[lev].build();
+            zeros[lev] = z;
+            
+            int zi = 0, oi = z;
+            for (int i = 0; i < n; i++) {
+                if (bitOf(cur[i], lev)) next[oi++] = cur[i];
+                else next[zi++] = cur[i];
+            }
+            swap(cur, next);
+        }
+    }
+    
+    T access(int i) const {
+        int rank = 0;
+        for (int lev = 0; lev < bits; lev++) {
+            if (levels[lev].get(i)) {
+                rank |= 1 << (bits - 1 - lev);
+                i = zeros[lev] + levels[lev].rank1(i);
+            } else {
+                i = levels[lev].rank0(i);
+            }
+        }
+        return values[rank];
+    }
+    
+    // k-th smallest in arr[l..r]; k is 0-based like the indices, so k = 0
+    // gives the minimum (same convention as RangeKthSmallest::kth)
+    T kthSmallest(int l, int r, int k) const {
+        r++;
+        int rank = 0;
+        for (int lev = 0; lev < bits; lev++) {
+            int ol = levels[lev].rank1(l), orr = levels[lev].rank1(r);
+            int zeroCount = (r - l) - (orr - ol);
+            if (k < zeroCount) {
+                l -= ol;
+                r -= orr;
+            } else {
+                k -= zeroCount;
+                rank |= 1 << (bits - 1 - lev);
+                l = zeros[lev] + ol;
+                r = zeros[lev] + orr;
+            }
+        }
+        return values[rank];
+    }
+    
+    // Number of elements of arr[l..r] that are < x
+    int countLess(int l, int r, const T& x) const {
+        int upper = lower_bound(values.begin(), values.end(), x) - values.begin();
+        return countLessRank(l, r + 1, upper);
+    }
+    
+    // Number of elements of arr[l..r] in [lo, hi)
+    int rangeFreq(int l, int r, const T& lo, const T& hi) const {
+        if (!(lo < hi)) return 0;
+        return countLess(l, r, hi) - countLess(l, r, lo);
+    }
+    
+    // Occurrences of x in arr[0..i)
+    int rank(const T& x, int i) const {
+        auto it = lower_bound(values.begin(), values.end(), x);
+        if (it == values.end() || *it != x) return 0;
+        int v = it - values.begin();
+        return countLessRank(0, i, v + 1) - countLessRank(0, i, v);
+    }
+    
+    // Position of the k-th (0-based) occurrence of x, or -1
+    int select(const T& x, int k) const {
+        auto it = lower_bound(values.begin(), values.end(), x);
+        if (it == values.end() || *it != x) return -1;
+        int v = it - values.begin();
+        
+        // Start of x's run on the bottom level
+        int pos = 0;
+        for (int lev = 0; lev < bits; lev++) {
+            if (bitOf(v, lev)) pos = zeros[lev] + levels[lev].rank1(pos);
+            else pos = levels[lev].rank0(pos);
+        }
+        pos += k;
+        
+        // Walk back up through the stable partitions
+        for (int lev = bits - 1; lev >= 0; lev--) {
+            if (bitOf(v, lev)) pos = levels[lev].select1(pos - zeros[lev]);
+            else pos = levels[lev].select0(pos);
+            if (pos < 0) return -1;
+        }
+        return pos;
+    }
+    
+    // The k most frequent values in arr[l..r] as {value, count}, most
+    // frequent first (ties by smaller value). Best-first search over the
+    // matrix nodes, largest ranges first.
+    vector<pair<T, int>> topK(int l, int r, int k) const {
+        struct Node {
+            int count, lev, l, r, rank;
+            bool operator<(const Node& o) const {
+                if (count != o.count) return count < o.count;
+                return rank > o.rank;
+            }
+        };
+        
+        vector<pair<T, int>> res;
+        priority_queue<Node> pq;
+        pq.push({r - l + 1, 0, l, r + 1, 0});
+        while (!pq.empty() && (int)res.size() < k) {
+            Node cur = pq.top();
+            pq.pop();
+            if (cur.lev == bits) {
+                res.push_back({values[cur.rank], cur.count});
+                continue;
+            }
+            const BitVector& bv = levels[cur.lev];
+            int ol = bv.rank1(cur.l), orr = bv.rank1(cur.r);
+            int zl = cur.l - ol, zr = cur.r - orr;
+            if (zr > zl) pq.push({zr - zl, cur.lev + 1, zl, zr, cur.rank});
+            if (orr > ol) {
+                pq.push({orr - ol, cur.lev + 1, zeros[cur.lev] + ol, zeros[cur.lev] + orr,
+                         cur.rank | 1 << (bits - 1 - cur.lev)});
+            }
+        }
+        return res;
+    }
+    
+    size_t memoryBytes() const {
+        size_t total = values.size() * sizeof(T);
+        for (auto& bv : levels) total += bv.memoryBytes();
+        return total;
+    }
+};
+
+// ============================================================================
+// SQRT DECOMPOSITION
+// ============================================================================
+
+// Blocks of a runtime-chosen size, each with its sum, a sorted copy (for
+// "count >= x") and an optional pending assignment. Partial blocks are
+// scanned with plain contiguous loops the compiler vectorizes.
+template <typename T>
+class SqrtDecomposition {
+public:
+    using Sum = common_type_t<T, long long>;
+    
+private:
+    vector<T> arr;
+    vector<T> sorted;           // same layout as arr, each block sorted
+    vector<Sum> blockSum;
+    vector<char> assigned;      // block holds a pending assignment
+    vector<T> assignVal;
+    int n, blockSize, numBlocks;
+    
+    int blockStart(int b) const { return b * blockSize; }
+    int blockEnd(int b) const { return min(n, (b + 1) * blockSize); }
+    
+    static Sum sumRange(const T* p, int len) {
+        Sum s = Sum(0);
+        for (int i = 0; i < len; i++) s += p[i];
+        return s;
+    }
+    
+    static int countAtLeastRange(const T* p, int len, T x) {
+        int c = 0;
+        for (int i = 0; i < len; i++) c += p[i] >= x;
+        return c;
+    }
+    
+    void rebuildBlock(int b) {
+        int s = blockStart(b), e = blockEnd(b);
+        blockSum[b] = sumRange(arr.data() + s, e - s);
+        copy(arr.begin() + s, arr.begin() + e, sorted.begin() + s);
+        sort(sorted.begin() + s, sorted.begin() + e);
+    }
+    
+    // Writes a pending assignment through to the elements
+    void materialize(int b) {
+        if (!assigned[b]) return;
+        fill(arr.begin() + blockStart(b), arr.begin() + blockEnd(b), assignVal[b]);
+        fill(sorted.begin() + blockStart(b), sorted.begin() + blockEnd(b), assignVal[b]);
+        assigned[b] = 0;
+    }
+    
+    // Visits [l, r] as partial head, whole blocks, partial tail
+    template <typename PartialFn, typename BlockFn>
+    void forRange(int l, int r, PartialFn partial, BlockFn whole) {
+        int bl = l / blockSize, br = r / blockSize;
+        if (bl == br) {
+            partial(bl, l, r + 1);
+            return;
+        }
+        partial(bl, l, blockEnd(bl));
+        for (int b = bl + 1; b < br; b++) whole(b);
+        partial(br, blockStart(br), r + 1);
     }
     
 public:
-    LazySegmentTree(vector<int>& arr) {
-        n = arr.size();
-        tree.resize(4 * n);
-        lazy.resize(4 * n, 0);
-        build(arr, 1, 0, n-1);
+    // blockSize = 0 picks sqrt(n log n), which balances the O(B) partial
+    // scans against the O((n / B) log B) sorted-block searches
+    SqrtDecomposition(const vector<T>& data, int blockSize = 0) : arr(data), n(data.size()) {
+        setBlockSize(blockSize);
+    }
+    
+    static int defaultBlockSize(int n) {
+        return max(16, (int)sqrt(n * log2(max(n, 2))));
+    }
+    
+    // Rebuilds all blocks with a new block size
+    void setBlockSize(int bs) {
+        for (int b = 0; b < (int)assigned.size(); b++) materialize(b);
+        blockSize = bs > 0 ? bs : defaultBlockSize(n);
+        numBlocks = (n + blockSize - 1) / blockSize;
+        sorted.assign(n, T());
+        blockSum.assign(numBlocks, Sum(0));
+        assigned.assign(numBlocks, 0);
+        assignVal.assign(numBlocks, T());
+        for (int b = 0; b < numBlocks; b++) rebuildBlock(b);
+    }
+    
+    int getBlockSize() const { return blockSize; }
+    
+    // Times a sample of random sum / count queries for block sizes around
+    // the default and keeps the fastest
+    int autoTune(int samples = 2000, int seed = 1) {
+        if (n == 0) {                       // nothing to sample
+            setBlockSize(0);
+            return blockSize;
+        }
+        mt19937 rng(seed);
+        vector<array<int, 2>> ranges(samples);
+        vector<T> thresholds(samples);
+        for (int i = 0; i < samples; i++) {
+            int l = rng() % n, r = rng() % n;
+            ranges[i] = {min(l, r), max(l, r)};
+            thresholds[i] = arr[rng() % n];
+        }
+        
+        int base = defaultBlockSize(n), best = base;
+        double bestTime = 1e18;
+        for (int bs : {base / 4, base / 2, base, base * 2, base * 4}) {
+            if (bs < 8) continue;
+            setBlockSize(bs);
+            auto start = chrono::steady_clock::now();
+            Sum sink = Sum(0);
+            for (int i = 0; i < samples; i++) {
+                sink += rangeSum(ranges[i][0], ranges[i][1]);
+                sink += countAtLeast(ranges[i][0], ranges[i][1], thresholds[i]);
+            }
+            double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (sink == Sum(-1)) t += 1;    // keep the loop observable
+            if (t < bestTime) {
+                bestTime = t;
+                best = bs;
+            }
+        }
+        setBlockSize(best);
+        return best;
+    }
+    
+    Sum rangeSum(int l, int r) {
+        Sum sum = Sum(0);
+        forRange(l, r,
+            [&](int b, int s, int e) {
+                if (assigned[b]) sum += Sum(assignVal[b]) * (e - s);
+                else sum += sumRange(arr.data() + s, e - s);
+            },
+            [&](int b) { sum += blockSum[b]; });
+        return sum;
+    }
+    
+    // Number of elements >= x in [l, r]
+    int countAtLeast(int l, int r, T x) {
+        int count = 0;
+        forRange(l, r,
+            [&](int b, int s, int e) {
+                if (assigned[b]) count += assignVal[b] >= x ? e - s : 0;
+                else count += countAtLeastRange(arr.data() + s, e - s, x);
+            },
+            [&](int b) {
+                if (assigned[b]) {
+                    count += assignVal[b] >= x ? blockEnd(b) - blockStart(b) : 0;
+                } else {
+                    auto first = sorted.begin() + blockStart(b), last = sorted.begin() + blockEnd(b);
+                    count += last - lower_bound(first, last, x);
+                }
+            });
+        return count;
     }
     
-    void updateRange(int l, int r, int val) {
-        updateRange(1, 0, n-1, l, r, val);
+    void updateElement(int idx, T val) {
+        int b = idx / blockSize;
+        materialize(b);
+        T old = arr[idx];
+        arr[idx] = val;
+        blockSum[b] += Sum(val) - Sum(old);
+        
+        // Move the old value's slot to val's place in the sorted block - O(B)
+        auto first = sorted.begin() + blockStart(b), last = sorted.begin() + blockEnd(b);
+        auto pos = lower_bound(first, last, old);
+        *pos = val;
+        while (pos + 1 != last && *(pos + 1) < *pos) {
+            iter_swap(pos, pos + 1);
+            ++pos;
+        }
+        while (pos != first && *pos < *(pos - 1)) {
+            iter_swap(pos, pos - 1);
+            --pos;
+        }
     }
     
-    int rangeSum(int l, int r) {
-        return query(1, 0, n-1, l, r);
+    // Sets every element of [l, r] to val
+    void rangeAssign(int l, int r, T val) {
+        forRange(l, r,
+            [&](int b, int s, int e) {
+                materialize(b);
+                fill(arr.begin() + s, arr.begin() + e, val);
+                rebuildBlock(b);
+            },
+            [&](int b) {
+                assigned[b] = 1;
+                assignVal[b] = val;
+                blockSum[b] = Sum(val) * (blockEnd(b) - blockStart(b));
+            });
     }
 };
 
 // ============================================================================
-// FENWICK TREE
+// MO'S ALGORITHM
 // ============================================================================
 
-class FenwickTree {
+// Offline engine: the caller supplies add(i) / remove(i) to grow and shrink
+// the current window and answer() to read it, so any order-independent
+// statistic (distinct count, mode frequency, ...) plugs in.
+class MoAlgorithm {
 private:
-    vector<int> tree;
-    int n;
-    
-    void update(int idx, int delta) {
-        while (idx <= n) {
-            tree[idx] += delta;
-            idx += idx & -idx;
+    // Position of (x, y) along a Hilbert curve over a 2^pow x 2^pow grid.
+    // Consecutive queries in this order move the window by about
+    // n / sqrt(q) per query, typically faster than plain block order.
+    static long long hilbertOrder(int x, int y, int pow) {
+        int side = 1 << pow;
+        long long d = 0;
+        for (int s = side / 2; s > 0; s /= 2) {
+            int rx = (x & s) > 0, ry = (y & s) > 0;
+            d += (long long)s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = side - 1 - x;
+                    y = side - 1 - y;
+                }
+                swap(x, y);
+            }
         }
+        return d;
     }
     
-    int query(int idx) {
-        int sum = 0;
-        while (idx > 0) {
-            sum += tree[idx];
-            idx -= idx & -idx;
+    static vector<int> hilbertSort(const vector<pair<int, int>>& ranges, int n) {
+        int pow = 0;
+        while ((1 << pow) < n) pow++;
+        
+        vector<long long> key(ranges.size());
+        for (int i = 0; i < (int)ranges.size(); i++) {
+            key[i] = hilbertOrder(ranges[i].first, ranges[i].second, pow);
         }
-        return sum;
+        vector<int> order(ranges.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](int a, int b) { return key[a] < key[b]; });
+        return order;
     }
     
-public:
-    FenwickTree(vector<int>& arr) {
-        n = arr.size();
-        tree.resize(n + 1, 0);
-        
-        for (int i = 0; i < n; i++) {
-            update(i + 1, arr[i]);
-        }
+    // Moves the window [l, r] to [ql, qr], growing before shrinking
+    template <typename AddFn, typename RemoveFn>
+    static void moveWindow(int& l, int& r, int ql, int qr, AddFn& add, RemoveFn& remove) {
+        while (l > ql) add(--l);
+        while (r < qr) add(++r);
+        while (l < ql) remove(l++);
+        while (r > qr) remove(r--);
     }
     
-    int rangeSum(int l, int r) {
-        return query(r + 1) - query(l);
+public:
+    // Queries are [l, r] over positions 0..n-1 - O((n + q) sqrt(q)) moves
+    template <typename AddFn, typename RemoveFn, typename AnswerFn>
+    static auto processQueries(int n, const vector<pair<int, int>>& queries,
+                               AddFn add, RemoveFn remove, AnswerFn answer)
+        -> vector<decltype(answer())> {
+        vector<decltype(answer())> results(queries.size());
+        int l = 0, r = -1;
+        for (int idx : hilbertSort(queries, n)) {
+            moveWindow(l, r, queries[idx].first, queries[idx].second, add, remove);
+            results[idx] = answer();
+        }
+        return results;
     }
     
-    void updateElement(int idx, int val) {
-        int oldVal = rangeSum(idx, idx);
-        update(idx + 1, val - oldVal);
+    // Mo's with updates: query {l, r, t} sees the array after the first t
+    // updates. apply(u, l, r) must toggle update u (e.g. swap the stored
+    // value with the array), fixing the window statistic if its position
+    // lies in the current window [l, r]; applying twice undoes it.
+    // Blocks of n^(2/3) give O(n^(5/3)) moves.
+    template <typename AddFn, typename RemoveFn, typename ApplyFn, typename AnswerFn>
+    static auto processQueriesWithUpdates(int n, const vector<array<int, 3>>& queries,
+                                          AddFn add, RemoveFn remove, ApplyFn apply,
+                                          AnswerFn answer)
+        -> vector<decltype(answer())> {
+        int block = max(1, (int)cbrt((double)n * n));
+        vector<int> order(queries.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](int a, int b) {
+            const auto& x = queries[a];
+            const auto& y = queries[b];
+            if (x[0] / block != y[0] / block) return x[0] / block < y[0] / block;
+            if (x[1] / block != y[1] / block) return x[1] / block < y[1] / block;
+            return x[2] < y[2];
+        });
+        
+        vector<decltype(answer())> results(queries.size());
+        int l = 0, r = -1, t = 0;
+        for (int idx : order) {
+            auto [ql, qr, qt] = queries[idx];
+            moveWindow(l, r, ql, qr, add, remove);
+            while (t < qt) apply(t++, l, r);
+            while (t > qt) apply(--t, l, r);
+            results[idx] = answer();
+        }
+        return results;
     }
-};
-
-// ============================================================================
-// SPARSE TABLE
-// ============================================================================
-
-class SparseTable {
-private:
-    vector<vector<int>> table;
-    vector<int> logTable;
-    int n;
     
-public:
-    SparseTable(vector<int>& arr) {
-        n = arr.size();
-        int logn = log2(n) + 1;
-        table.resize(n, vector<int>(logn));
+    // Mo's on trees: path queries {u, v} on a rooted tree. The Euler tour
+    // lists each node at entry and exit, so a path is a tour range in which
+    // nodes seen twice cancel out, plus the LCA when it is not an endpoint.
+    // add(node) / remove(node) receive tree nodes.
+    template <typename AddFn, typename RemoveFn, typename AnswerFn>
+    static auto processPathQueries(const vector<vector<int>>& adj, int root,
+                                   const vector<pair<int, int>>& queries,
+                                   AddFn add, RemoveFn remove, AnswerFn answer)
+        -> vector<decltype(answer())> {
+        int n = adj.size(), LOG = 1;
+        while ((1 << LOG) < n) LOG++;
         
-        for (int i = 0; i < n; i++) {
-            table[i][0] = arr[i];
+        // Iterative DFS: entry/exit times, depth and binary-lifting table
+        vector<int> tin(n), tout(n), depth(n, 0), tour(2 * n);
+        vector<vector<int>> up(LOG, vector<int>(n, root));
+        vector<int> stk = {root}, next(n, 0);
+        int timer = 0;
+        tin[root] = timer;
+        tour[timer++] = root;
+        while (!stk.empty()) {
+            int u = stk.back();
+            if (next[u] < (int)adj[u].size()) {
+                int v = adj[u][next[u]++];
+                if (v == up[0][u] && u != root) continue;
+                up[0][v] = u;
+                depth[v] = depth[u] + 1;
+                tin[v] = timer;
+                tour[timer++] = v;
+                stk.push_back(v);
+            } else {
+                tout[u] = timer;
+                tour[timer++] = u;
+                stk.pop_back();
+            }
+        }
+        for (int k = 1; k < LOG; k++) {
+            for (int v = 0; v < n; v++) up[k][v] = up[k-1][up[k-1][v]];
         }
         
-        for (int j = 1; (1 << j) <= n; j++) {
-            for (int i = 0; i + (1 << j) <= n; i++) {
-                table[i][j] = min(table[i][j-1], 
-                                 table[i + (1 << (j-1))][j-1]);
+        auto lca = [&](int a, int b) {
+            if (depth[a] < depth[b]) swap(a, b);
+            for (int k = LOG - 1; k >= 0; k--) {
+                if (depth[a] - (1 << k) >= depth[b]) a = up[k][a];
+            }
+            if (a == b) return a;
+            for (int k = LOG - 1; k >= 0; k--) {
+                if (up[k][a] != up[k][b]) {
+                    a = up[k][a];
+                    b = up[k][b];
+                }
+            }
+            return up[0][a];
+        };
+        
+        vector<pair<int, int>> ranges(queries.size());
+        vector<int> extra(queries.size(), -1);
+        for (int i = 0; i < (int)queries.size(); i++) {
+            auto [u, v] = queries[i];
+            if (tin[u] > tin[v]) swap(u, v);
+            int w = lca(u, v);
+            if (w == u) {
+                ranges[i] = {tin[u], tin[v]};
+            } else {
+                ranges[i] = {tout[u], tin[v]};
+                extra[i] = w;
             }
         }
         
-        logTable.resize(n + 1);
-        for (int i = 2; i <= n; i++) {
-            logTable[i] = logTable[i/2] + 1;
+        vector<char> inWindow(n, 0);
+        auto toggle = [&](int pos) {
+            int node = tour[pos];
+            if (inWindow[node]) remove(node);
+            else add(node);
+            inWindow[node] ^= 1;
+        };
+        
+        vector<decltype(answer())> results(queries.size());
+        int l = 0, r = -1;
+        for (int idx : hilbertSort(ranges, 2 * n)) {
+            moveWindow(l, r, ranges[idx].first, ranges[idx].second, toggle, toggle);
+            if (extra[idx] != -1) add(extra[idx]);
+            results[idx] = answer();
+            if (extra[idx] != -1) remove(extra[idx]);
         }
-    }
-    
-    int rangeMin(int l, int r) {
-        int k = logTable[r - l + 1];
-        return min(table[l][k], table[r - (1 << k) + 1][k]);
+        return results;
     }
 };
 
 // ============================================================================
-// SQRT DECOMPOSITION
+// PARALLEL BATCH QUERIES
 // ============================================================================
 
-class SqrtDecomposition {
+// Fixed set of worker threads fed from one task queue (build with -pthread)
+class ThreadPool {
 private:
-    vector<int> arr, block;
-    int blockSize;
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex mtx;
+    condition_variable taskReady, allDone;
+    int pending = 0;
+    bool stopping = false;
     
-    void build(vector<int>& data) {
-        arr = data;
-        blockSize = sqrt(arr.size()) + 1;
-        block.resize(blockSize);
-        
-        for (int i = 0; i < arr.size(); i++) {
-            block[i / blockSize] += arr[i];
+    void workerLoop() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> lock(mtx);
+                taskReady.wait(lock, [&] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;
+                task = move(tasks.front());
+                tasks.pop();
+            }
+            task();
+            {
+                lock_guard<mutex> lock(mtx);
+                if (--pending == 0) allDone.notify_all();
+            }
         }
     }
     
-    int query(int l, int r) {
-        int sum = 0;
-        
-        while (l < r && l % blockSize != 0) {
-            sum += arr[l];
-            l++;
-        }
-        
-        while (l + blockSize <= r) {
-            sum += block[l / blockSize];
-            l += blockSize;
-        }
-        
-        while (l <= r) {
-            sum += arr[l];
-            l++;
+public:
+    ThreadPool(int threads = thread::hardware_concurrency()) {
+        threads = max(threads, 1);
+        for (int i = 0; i < threads; i++) {
+            workers.emplace_back([this] { workerLoop(); });
         }
-        
-        return sum;
     }
     
-    void update(int idx, int val) {
-        block[idx / blockSize] += val - arr[idx];
-        arr[idx] = val;
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        taskReady.notify_all();
+        for (auto& w : workers) w.join();
     }
     
-public:
-    SqrtDecomposition(vector<int>& data) {
-        build(data);
-    }
+    int size() const { return workers.size(); }
     
-    int rangeSum(int l, int r) {
-        return query(l, r);
+    void submit(function<void()> task) {
+        {
+            lock_guard<mutex> lock(mtx);
+            tasks.push(move(task));
+            pending++;
+        }
+        taskReady.notify_one();
     }
     
-    void updateElement(int idx, int val) {
-        update(idx, val);
+    // Blocks until every submitted task has finished
+    void wait() {
+        unique_lock<mutex> lock(mtx);
+        allDone.wait(lock, [&] { return pending == 0; });
     }
 };
 
-// ============================================================================
-// MO'S ALGORITHM
-// ============================================================================
-
-class MoAlgorithm {
+// Answers a batch of read-only [l, r] queries on a thread pool.
+// Queries are ordered by l so each worker walks a narrow region of the
+// structure, split into chunks for load balancing, and written back by
+// original index. The query callable must be safe to call concurrently,
+// i.e. use a const structure (not LazySegmentTree, whose query pushes).
+class BatchQueryExecutor {
 private:
-    int blockSize;
+    ThreadPool pool;
+    int chunkSize;
     
-    struct Query {
+    struct IndexedQuery {
         int l, r, idx;
-        
-        bool operator<(const Query& other) const {
-            if (l / blockSize != other.l / blockSize) {
-                return l / blockSize < other.l / blockSize;
-            }
-            return ((l / blockSize) & 1) ? r < other.r : r > other.r;
-        }
     };
     
-public:
-    vector<int> processQueries(vector<int>& arr, 
-                                vector<pair<int, int>>& queries) {
-        int n = arr.size();
-        blockSize = sqrt(n);
+    // Counting sort on the high bits of l into a packed copy: O(q), close
+    // enough to a full sort for locality, and workers then read their
+    // chunk sequentially instead of gathering through an index array
+    static vector<IndexedQuery> localityOrder(const vector<pair<int, int>>& queries) {
+        int q = queries.size(), maxL = 0;
+        for (auto& [l, r] : queries) maxL = max(maxL, l);
+        int shift = 0;
+        while ((maxL >> shift) >= max(q, 1)) shift++;
         
-        vector<Query> q(queries.size());
-        for (int i = 0; i < queries.size(); i++) {
-            q[i] = {queries[i].first, queries[i].second, i};
-        }
-        
-        sort(q.begin(), q.end());
-        
-        vector<int> results(queries.size());
-        int currentSum = 0;
-        int l = 0, r = -1;
+        vector<int> start((maxL >> shift) + 2, 0);
+        for (auto& [l, r] : queries) start[(l >> shift) + 1]++;
+        partial_sum(start.begin(), start.end(), start.begin());
         
-        for (auto& query : q) {
-            while (l > query.l) {
-                l--;
-                currentSum += arr[l];
-            }
-            while (r < query.r) {
-                r++;
-                currentSum += arr[r];
-            }
-            while (l < query.l) {
-                currentSum -= arr[l];
-                l++;
-            }
-            while (r > query.r) {
-                currentSum -= arr[r];
-                r--;
-            }
-            results[query.idx] = currentSum;
+        vector<IndexedQuery> sorted(q);
+        for (int i = 0; i < q; i++) {
+            auto [l, r] = queries[i];
+            sorted[start[l >> shift]++] = {l, r, i};
         }
+        return sorted;
+    }
+    
+public:
+    BatchQueryExecutor(int threads = thread::hardware_concurrency(), int chunkSize = 4096)
+        : pool(threads), chunkSize(chunkSize) {}
+    
+    int threads() const { return pool.size(); }
+    
+    // Results are stored by value, so queries may return references. bool is
+    // rejected: vector<bool> packs bits, and writes from different chunks to
+    // neighbouring indices would race on a shared word; return char instead.
+    template <typename QueryFn, typename R = decay_t<invoke_result_t<QueryFn&, int, int>>>
+    vector<R> run(const vector<pair<int, int>>& queries, QueryFn query) {
+        static_assert(!is_same_v<R, bool>, "return char, not bool, from batched queries");
+        int q = queries.size();
+        vector<IndexedQuery> sorted = localityOrder(queries);
         
+        vector<R> results(q);
+        for (int begin = 0; begin < q; begin += chunkSize) {
+            int end = min(q, begin + chunkSize);
+            pool.submit([&, begin, end] {
+                for (int i = begin; i < end; i++) {
+                    results[sorted[i].idx] = query(sorted[i].l, sorted[i].r);
+                }
+            });
+        }
+        pool.wait();
         return results;
     }
 };
@@ -346,42 +2015,125 @@ void testSegmentTree() {
     cout << "Testing Segment Tree:" << endl;
     
     vector<int> arr = {1, 2, 3, 4, 5};
-    SegmentTree st(arr);
+    SegmentTree<int> st(arr);
     
     cout << "Array: ";
     for (int x : arr) cout << x << " ";
     cout << endl;
     
-    cout << "Sum [0,2]: " << st.rangeSum(0, 2) << endl;
-    cout << "Sum [1,4]: " << st.rangeSum(1, 4) << endl;
+    cout << "Sum [0,2]: " << st.query(0, 2) << endl;
+    cout << "Sum [1,4]: " << st.query(1, 4) << endl;
     
     st.updateElement(2, 10);
     cout << "After updating index 2 to 10:" << endl;
-    cout << "Sum [0,2]: " << st.rangeSum(0, 2) << endl;
+    cout << "Sum [0,2]: " << st.query(0, 2) << endl;
+    
+    MinSegmentTree<int> minTree(arr);
+    GcdSegmentTree<int> gcdTree(vector<int>{12, 18, 24, 36});
+    cout << "Min [1,4]: " << minTree.query(1, 4) << endl;
+    cout << "Gcd of {12, 18, 24, 36}: " << gcdTree.query(0, 3) << endl;
+    
+    // 64-bit sums do not overflow where int would
+    vector<long long> big(4, 2000000000LL);
+    SumSegmentTree<long long> bigTree(big);
+    cout << "64-bit sum [0,3]: " << bigTree.query(0, 3) << endl;
+    
+    cout << endl;
+}
+
+void testIterativeSegmentTrees() {
+    cout << "Testing Iterative and Wide Segment Trees:" << endl;
     
+    vector<int> arr = {5, 3, 8, 6, 1, 9, 2, 7};
+    IterativeSegmentTree<int, MaxOp<int>> it(arr);
+    WideSegmentTree<int, MinOp<int>> wide(arr);
+    
+    cout << "Max [1,4]: " << it.query(1, 4) << endl;
+    cout << "Min [1,4]: " << wide.query(1, 4) << endl;
+    
+    cout << "Update index 2 to 0" << endl;
+    it.updateElement(2, 0);
+    wide.updateElement(2, 0);
+    
+    cout << "Max [1,4]: " << it.query(1, 4) << endl;
+    cout << "Min [1,4]: " << wide.query(1, 4) << endl;
     cout << endl;
 }
 
 void testLazySegmentTree() {
     cout << "Testing Lazy Segment Tree:" << endl;
     
-    vector<int> arr = {1, 2, 3, 4, 5};
-    LazySegmentTree lst(arr);
+    vector<long long> arr = {1, 2, 3, 4, 5};
+    vector<RangeStats<long long>> leaves;
+    for (long long x : arr) leaves.push_back(RangeStats<long long>::leaf(x));
     
-    cout << "Range sum [1,3]: " << lst.rangeSum(1, 3) << endl;
+    using Action = AffineAction<long long>;
+    AffineSegmentTree<long long> lst(leaves);
+    
+    cout << "Range sum [1,3]: " << lst.query(1, 3).sum << endl;
     
     cout << "Update range [1,3] by adding 2" << endl;
-    lst.updateRange(1, 3, 2);
+    lst.updateRange(1, 3, Action::add(2));
+    cout << "Range sum [1,3]: " << lst.query(1, 3).sum << endl;
+    
+    cout << "Assign 7 on [0,1], then x -> 3x - 1 on [1,4]" << endl;
+    lst.updateRange(0, 1, Action::assign(7));
+    lst.updateRange(1, 4, Action::affine(3, -1));
+    auto all = lst.query(0, 4);
+    cout << "Sum / min / max [0,4]: " << all.sum << " / " << all.mn << " / " << all.mx << endl;
+    
+    cout << "Batch: add 1 on [0,4], negate [2,3]" << endl;
+    lst.updateBatch({{0, 4, Action::add(1)}, {2, 3, Action::affine(-1, 0)}});
+    all = lst.query(0, 4);
+    cout << "Sum / min / max [0,4]: " << all.sum << " / " << all.mn << " / " << all.mx << endl;
+    cout << endl;
+}
+
+void testSegmentTreeBeats() {
+    cout << "Testing Segment Tree Beats:" << endl;
+    
+    SegmentTreeBeats beats({8, 3, 9, 1, 7, 4});
+    cout << "Sum [0,5]: " << beats.rangeSum(0, 5) << endl;
+    
+    cout << "Clamp [0,5] to at most 5" << endl;
+    beats.chmin(0, 5, 5);
+    cout << "Sum [0,5]: " << beats.rangeSum(0, 5) << ", max: " << beats.rangeMax(0, 5) << endl;
+    
+    cout << "Raise [2,4] to at least 4, then add 2 to [0,2]" << endl;
+    beats.chmax(2, 4, 4);
+    beats.rangeAdd(0, 2, 2);
+    cout << "Sum [0,5]: " << beats.rangeSum(0, 5) << ", min: " << beats.rangeMin(0, 5)
+         << ", max: " << beats.rangeMax(0, 5) << endl;
+    cout << endl;
+}
+
+void testPersistentSegmentTree() {
+    cout << "Testing Persistent Segment Tree:" << endl;
     
-    cout << "Range sum [1,3]: " << lst.rangeSum(1, 3) << endl;
+    vector<long long> arr = {1, 2, 3, 4, 5};
+    PersistentSegmentTree<long long> pst(arr);
+    
+    int v1 = pst.updateElement(0, 2, 10);
+    int v2 = pst.add(v1, 0, 100);
+    
+    cout << "Sum [0,4] at versions 0, 1, 2: " << pst.query(0, 0, 4) << ", "
+         << pst.query(v1, 0, 4) << ", " << pst.query(v2, 0, 4) << endl;
+    for (int v = 0; v < pst.versions(); v++) {
+        cout << "Version " << v << " memory: " << pst.memoryUsage(v) << " bytes" << endl;
+    }
+    
+    vector<int> data = {5, 1, 4, 2, 3, 1};
+    RangeKthSmallest<int> kth(data);
+    cout << "2nd smallest (k = 1) in [1,4]: " << kth.kth(1, 4, 1) << endl;
+    cout << "3rd smallest (k = 2) in [0,5]: " << kth.kth(0, 5, 2) << endl;
     cout << endl;
 }
 
 void testFenwickTree() {
     cout << "Testing Fenwick Tree:" << endl;
     
-    vector<int> arr = {1, 2, 3, 4, 5};
-    FenwickTree ft(arr);
+    vector<long long> arr = {1, 2, 3, 4, 5};
+    FenwickTree<long long> ft(arr);
     
     cout << "Range sum [0,2]: " << ft.rangeSum(0, 2) << endl;
     cout << "Range sum [1,4]: " << ft.rangeSum(1, 4) << endl;
@@ -390,6 +2142,42 @@ void testFenwickTree() {
     ft.updateElement(2, 10);
     
     cout << "Range sum [0,2]: " << ft.rangeSum(0, 2) << endl;
+    cout << "Element 2: " << ft.get(2) << endl;
+    cout << "First prefix reaching 13: index " << ft.lowerBound(13) << endl;
+    
+    RangeFenwickTree<long long> rft(arr);
+    cout << "Add 3 to range [1,3]" << endl;
+    rft.rangeAdd(1, 3, 3);
+    cout << "Range sum [0,4]: " << rft.rangeSum(0, 4) << endl;
+    cout << "Range sum [3,4]: " << rft.rangeSum(3, 4) << endl;
+    
+    FenwickTree2D<int> grid({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+    cout << "Rectangle sum (1,1)-(2,2): " << grid.rectSum(1, 1, 2, 2) << endl;
+    grid.add(1, 1, 10);
+    cout << "After adding 10 at (1,1): " << grid.rectSum(1, 1, 2, 2) << endl;
+    cout << endl;
+}
+
+void test2DRangeQueries() {
+    cout << "Testing 2D Range Queries:" << endl;
+    
+    // Sparse points on a 1e9 x 1e9 grid
+    vector<pair<long long, long long>> cells = {{5, 5}, {1000000000, 7}, {300, 800000}, {5, 900}};
+    CompressedFenwick2D<long long, long long> grid(cells);
+    grid.add(5, 5, 3);
+    grid.add(300, 800000, 4);
+    grid.add(5, 900, 10);
+    cout << "Sum x in [0,1000], y in [0,1000]: " << grid.rectSum(0, 0, 1000, 1000) << endl;
+    grid.add(1000000000, 7, 1);
+    cout << "Sum x in [5,1e9], y in [0,10]: " << grid.rectSum(5, 0, 1000000000, 10) << endl;
+    
+    vector<tuple<int, int, long long>> points = {{1, 1, 1}, {2, 3, 2}, {4, 2, 3}, {4, 4, 4}};
+    vector<array<int, 4>> rects = {{1, 1, 4, 4}, {2, 2, 4, 3}, {3, 0, 5, 5}};
+    auto sums = rectangleSumsOffline(points, rects);
+    for (int i = 0; i < (int)rects.size(); i++) {
+        cout << "Rectangle (" << rects[i][0] << "," << rects[i][1] << ")-(" << rects[i][2]
+             << "," << rects[i][3] << "): " << sums[i] << endl;
+    }
     cout << endl;
 }
 
@@ -397,14 +2185,44 @@ void testSparseTable() {
     cout << "Testing Sparse Table:" << endl;
     
     vector<int> arr = {4, 2, 1, 3, 5, 2, 1};
-    SparseTable st(arr);
+    SparseTable<int> st(arr);
+    SparseTable<int, MaxOp<int>> maxTable(arr);
+    
+    cout << "Array: ";
+    for (int x : arr) cout << x << " ";
+    cout << endl;
+    
+    cout << "Min in [0,3]: " << st.query(0, 3) << endl;
+    cout << "Min in [2,5]: " << st.query(2, 5) << endl;
+    cout << "Max in [0,3]: " << maxTable.query(0, 3) << endl;
+    
+    BlockRMQ<int> rmq(arr);
+    cout << "Block RMQ min in [3,6]: " << rmq.query(3, 6)
+         << " at index " << rmq.queryIndex(3, 6) << endl;
+    cout << endl;
+}
+
+void testWaveletMatrix() {
+    cout << "Testing Wavelet Matrix:" << endl;
+    
+    vector<int> arr = {5, 1, 4, 2, 3, 1, 5, 5};
+    WaveletMatrix<int> wm(arr);
     
     cout << "Array: ";
     for (int x : arr) cout << x << " ";
     cout << endl;
     
-    cout << "Min in [0,3]: " << st.rangeMin(0, 3) << endl;
-    cout << "Min in [2,5]: " << st.rangeMin(2, 5) << endl;
+    cout << "2nd smallest (k = 1) in [1,4]: " << wm.kthSmallest(1, 4, 1) << endl;
+    cout << "Count < 4 in [0,7]: " << wm.countLess(0, 7, 4) << endl;
+    cout << "Count in [2,5) over [2,6]: " << wm.rangeFreq(2, 6, 2, 5) << endl;
+    cout << "Position of second 5: " << wm.select(5, 1) << endl;
+    
+    cout << "Top 2 frequent in [0,7]:";
+    for (auto [value, count] : wm.topK(0, 7, 2)) {
+        cout << " " << value << "(x" << count << ")";
+    }
+    cout << endl;
+    cout << "Memory: " << wm.memoryBytes() << " bytes" << endl;
     cout << endl;
 }
 
@@ -412,7 +2230,7 @@ void testSqrtDecomposition() {
     cout << "Testing Sqrt Decomposition:" << endl;
     
     vector<int> arr = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-    SqrtDecomposition sd(arr);
+    SqrtDecomposition<int> sd(arr, 3);
     
     cout << "Array: ";
     for (int x : arr) cout << x << " ";
@@ -425,21 +2243,499 @@ void testSqrtDecomposition() {
     sd.updateElement(4, 50);
     
     cout << "Sum [2,7]: " << sd.rangeSum(2, 7) << endl;
+    cout << "Count >= 7 in [0,8]: " << sd.countAtLeast(0, 8, 7) << endl;
+    
+    cout << "Assign 0 to [1,6]" << endl;
+    sd.rangeAssign(1, 6, 0);
+    cout << "Sum [0,8]: " << sd.rangeSum(0, 8) << endl;
+    cout << "Count >= 1 in [0,8]: " << sd.countAtLeast(0, 8, 1) << endl;
+    
+    vector<int> big(1 << 16);
+    iota(big.begin(), big.end(), 0);
+    SqrtDecomposition<int> tuned(big);
+    cout << "Default block size for n = " << big.size() << ": " << tuned.getBlockSize() << endl;
+    cout << "Auto-tuned block size: " << tuned.autoTune() << endl;
+    cout << endl;
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+// Times random range queries and point updates on one tree type.
+// The checksum keeps the optimizer from dropping the queries and lets
+// the different implementations be compared for agreement.
+template <typename Tree>
+void benchmarkTree(const string& name, const vector<int>& arr,
+                   const vector<pair<int, int>>& queries,
+                   const vector<pair<int, int>>& updates) {
+    using Clock = chrono::steady_clock;
+    Tree tree(arr);
+    
+    auto start = Clock::now();
+    long long checksum = 0;
+    for (auto& [l, r] : queries) {
+        checksum += tree.query(l, r);
+    }
+    auto mid = Clock::now();
+    for (auto& [idx, val] : updates) {
+        tree.updateElement(idx, val);
+    }
+    auto end = Clock::now();
+    
+    double queryNs = chrono::duration<double, nano>(mid - start).count() / queries.size();
+    double updateNs = chrono::duration<double, nano>(end - mid).count() / updates.size();
+    cout << setw(24) << left << name << right
+         << " query: " << setw(7) << fixed << setprecision(1) << queryNs << " ns/op"
+         << "   update: " << setw(7) << updateNs << " ns/op"
+         << "   checksum: " << checksum << defaultfloat << endl;
+}
+
+void benchmarkSegmentTrees(int n, int ops) {
+    cout << "Benchmarking segment trees (n = " << n << ", ops = " << ops << "):" << endl;
+    
+    mt19937 rng(42);
+    vector<int> arr(n);
+    for (int& x : arr) x = rng() % 100;
+    
+    vector<pair<int, int>> queries(ops), updates(ops);
+    for (auto& [l, r] : queries) {
+        l = rng() % n;
+        r = rng() % n;
+        if (l > r) swap(l, r);
+    }
+    for (auto& [idx, val] : updates) {
+        idx = rng() % n;
+        val = rng() % 100;
+    }
+    
+    benchmarkTree<SegmentTree<int>>("SegmentTree", arr, queries, updates);
+    benchmarkTree<IterativeSegmentTree<int>>("IterativeSegmentTree", arr, queries, updates);
+    benchmarkTree<WideSegmentTree<int>>("WideSegmentTree", arr, queries, updates);
+    cout << endl;
+}
+
+void testMoAlgorithm() {
+    cout << "Testing Mo's Algorithm:" << endl;
+    
+    vector<int> arr = {1, 2, 1, 3, 2, 2, 4};
+    vector<pair<int, int>> queries = {{0, 2}, {1, 5}, {0, 6}, {3, 3}};
+    
+    // Distinct count and highest frequency in the window
+    vector<int> cnt(5, 0), cntOfCnt(arr.size() + 1, 0);
+    int distinct = 0, mode = 0;
+    auto add = [&](int i) {
+        int& c = cnt[arr[i]];
+        if (c++ == 0) distinct++;
+        cntOfCnt[c - 1]--;
+        cntOfCnt[c]++;
+        mode = max(mode, c);
+    };
+    auto remove = [&](int i) {
+        int& c = cnt[arr[i]];
+        if (--c == 0) distinct--;
+        cntOfCnt[c + 1]--;
+        cntOfCnt[c]++;
+        if (cntOfCnt[mode] == 0) mode--;
+    };
+    auto answer = [&]() { return make_pair(distinct, mode); };
+    
+    auto results = MoAlgorithm::processQueries(arr.size(), queries, add, remove, answer);
+    for (int i = 0; i < (int)queries.size(); i++) {
+        cout << "[" << queries[i].first << "," << queries[i].second << "] distinct: "
+             << results[i].first << ", mode frequency: " << results[i].second << endl;
+    }
+    
+    // Distinct count with point assignments: update u sets arr[pos] = val
+    fill(cnt.begin(), cnt.end(), 0);
+    fill(cntOfCnt.begin(), cntOfCnt.end(), 0);
+    distinct = mode = 0;
+    vector<pair<int, int>> updates = {{1, 1}, {6, 1}};
+    auto apply = [&](int u, int l, int r) {
+        auto& [pos, val] = updates[u];
+        bool inside = l <= pos && pos <= r;
+        if (inside) remove(pos);
+        swap(arr[pos], val);
+        if (inside) add(pos);
+    };
+    vector<array<int, 3>> timed = {{0, 6, 0}, {0, 6, 1}, {0, 6, 2}, {4, 6, 2}};
+    auto timedResults = MoAlgorithm::processQueriesWithUpdates(
+        arr.size(), timed, add, remove, apply, [&]() { return distinct; });
+    for (int i = 0; i < (int)timed.size(); i++) {
+        cout << "[" << timed[i][0] << "," << timed[i][1] << "] after " << timed[i][2]
+             << " updates, distinct: " << timedResults[i] << endl;
+    }
+    
+    // Distinct colors on tree paths
+    vector<vector<int>> adj = {{1, 2}, {0, 3, 4}, {0, 5}, {1}, {1}, {2}};
+    vector<int> color = {1, 2, 1, 3, 2, 4};
+    fill(cnt.begin(), cnt.end(), 0);
+    distinct = 0;
+    auto addNode = [&](int v) { if (cnt[color[v]]++ == 0) distinct++; };
+    auto removeNode = [&](int v) { if (--cnt[color[v]] == 0) distinct--; };
+    vector<pair<int, int>> paths = {{3, 5}, {3, 4}, {0, 5}};
+    auto pathResults = MoAlgorithm::processPathQueries(
+        adj, 0, paths, addNode, removeNode, [&]() { return distinct; });
+    for (int i = 0; i < (int)paths.size(); i++) {
+        cout << "Path " << paths[i].first << "-" << paths[i].second
+             << " distinct colors: " << pathResults[i] << endl;
+    }
+    cout << endl;
+}
+
+void testBatchQueries() {
+    cout << "Testing Parallel Batch Queries:" << endl;
+    
+    vector<int> arr = {4, 2, 1, 3, 5, 2, 1};
+    SparseTable<int> st(arr);
+    FenwickTree<int> ft(arr);
+    
+    BatchQueryExecutor executor(2, 2);
+    vector<pair<int, int>> queries = {{3, 6}, {0, 1}, {2, 4}, {0, 6}};
+    auto mins = executor.run(queries, [&](int l, int r) { return st.query(l, r); });
+    auto sums = executor.run(queries, [&](int l, int r) { return ft.rangeSum(l, r); });
+    
+    for (int i = 0; i < (int)queries.size(); i++) {
+        cout << "[" << queries[i].first << "," << queries[i].second << "] min: "
+             << mins[i] << ", sum: " << sums[i] << endl;
+    }
+    cout << endl;
+}
+
+// Throughput of sequential vs. batched execution of the same queries
+template <typename QueryFn>
+void benchmarkBatch(const string& name, BatchQueryExecutor& executor,
+                    const vector<pair<int, int>>& queries, QueryFn query) {
+    using Clock = chrono::steady_clock;
+    
+    auto start = Clock::now();
+    long long sequential = 0;
+    for (auto& [l, r] : queries) sequential += query(l, r);
+    auto mid = Clock::now();
+    auto results = executor.run(queries, query);
+    auto end = Clock::now();
+    
+    long long batched = accumulate(results.begin(), results.end(), 0LL);
+    double seqRate = queries.size() / chrono::duration<double>(mid - start).count() / 1e6;
+    double batchRate = queries.size() / chrono::duration<double>(end - mid).count() / 1e6;
+    cout << setw(24) << left << name << right << fixed << setprecision(2)
+         << " sequential: " << setw(7) << seqRate << " Mq/s"
+         << "   batched: " << setw(7) << batchRate << " Mq/s"
+         << (sequential == batched ? "" : "   MISMATCH") << defaultfloat << endl;
+}
+
+void benchmarkBatchQueries(int n, int q) {
+    BatchQueryExecutor executor;
+    cout << "Benchmarking batch queries (n = " << n << ", queries = " << q
+         << ", threads = " << executor.threads() << "):" << endl;
+    
+    mt19937 rng(7);
+    vector<int> arr(n);
+    for (int& x : arr) x = rng() % 1000;
+    vector<pair<int, int>> queries(q);
+    for (auto& [l, r] : queries) {
+        l = rng() % n;
+        r = rng() % n;
+        if (l > r) swap(l, r);
+    }
+    
+    SegmentTree<long long> seg(vector<long long>(arr.begin(), arr.end()));
+    IterativeSegmentTree<long long> iter(vector<long long>(arr.begin(), arr.end()));
+    WideSegmentTree<int, MinOp<int>> wide(arr);
+    FenwickTree<long long> fenwick(vector<long long>(arr.begin(), arr.end()));
+    SparseTable<int> sparse(arr);
+    BlockRMQ<int> blockRmq(arr);
+    
+    benchmarkBatch("SegmentTree (sum)", executor, queries,
+                   [&](int l, int r) { return seg.query(l, r); });
+    benchmarkBatch("IterativeSegmentTree", executor, queries,
+                   [&](int l, int r) { return iter.query(l, r); });
+    benchmarkBatch("WideSegmentTree (min)", executor, queries,
+                   [&](int l, int r) { return wide.query(l, r); });
+    benchmarkBatch("FenwickTree", executor, queries,
+                   [&](int l, int r) { return fenwick.rangeSum(l, r); });
+    benchmarkBatch("SparseTable (min)", executor, queries,
+                   [&](int l, int r) { return sparse.query(l, r); });
+    benchmarkBatch("BlockRMQ (min)", executor, queries,
+                   [&](int l, int r) { return blockRmq.query(l, r); });
+    cout << endl;
+}
+
+// ============================================================================
+// WORKLOAD HARNESS AND STRUCTURE SELECTION
+// ============================================================================
+
+// Hardware cache-miss counter for the calling thread via perf_event_open.
+// Reports -1 where perf events are unavailable (non-Linux, containers,
+// perf_event_paranoid too strict).
+class CacheMissCounter {
+private:
+    int fd = -1;
+    
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd != -1) close(fd);
+#endif
+    }
+    
+    bool available() const { return fd != -1; }
+    
+    void start() {
+#ifdef __linux__
+        if (fd == -1) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    
+    long long stop() {
+#ifdef __linux__
+        if (fd == -1) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+};
+
+struct WorkloadProfile {
+    enum QueryKind { SUM, MIN };
+    enum LengthDist { UNIFORM, SHORT, FULL };
+    
+    string name;
+    int n;
+    int ops;
+    double readRatio;       // fraction of operations that are range queries
+    QueryKind kind;
+    LengthDist lengths;     // SHORT: length uniform in [1, shortLength]
+    int shortLength = 64;
+};
+
+struct WorkloadResult {
+    string structure;
+    double nsPerOp;
+    long long cacheMisses;  // -1 when not measured
+};
+
+class RangeQueryHarness {
+private:
+    struct Operation {
+        bool isQuery;
+        int a, b;           // [l, r] for queries, (idx, val) for updates
+    };
+    
+    static vector<Operation> generateOps(const WorkloadProfile& p, mt19937& rng) {
+        vector<Operation> ops(p.ops);
+        for (auto& op : ops) {
+            op.isQuery = uniform_real_distribution<double>(0, 1)(rng) < p.readRatio;
+            if (!op.isQuery) {
+                op.a = rng() % p.n;
+                op.b = rng() % 1000;
+                continue;
+            }
+            int l, r;
+            if (p.lengths == WorkloadProfile::FULL) {
+                l = rng() % max(1, p.n / 16);
+                r = p.n - 1 - rng() % max(1, p.n / 16);
+            } else if (p.lengths == WorkloadProfile::SHORT) {
+                int len = 1 + rng() % min(p.n, max(1, p.shortLength));
+                l = rng() % (p.n - len + 1);
+                r = l + len - 1;
+            } else {
+                l = rng() % p.n;
+                r = rng() % p.n;
+                if (l > r) swap(l, r);
+            }
+            op.a = l;
+            op.b = r;
+        }
+        return ops;
+    }
+    
+    template <typename QueryFn, typename UpdateFn>
+    static WorkloadResult run(const string& name, const vector<Operation>& ops,
+                              QueryFn query, UpdateFn update) {
+        CacheMissCounter counter;
+        long long checksum = 0;
+        
+        counter.start();
+        auto start = chrono::steady_clock::now();
+        for (auto& op : ops) {
+            if (op.isQuery) checksum += query(op.a, op.b);
+            else update(op.a, op.b);
+        }
+        auto end = chrono::steady_clock::now();
+        long long misses = counter.stop();
+        
+        double ns = chrono::duration<double, nano>(end - start).count() / max<size_t>(ops.size(), 1);
+        if (checksum == LLONG_MIN) ns += 1;     // keep the queries observable
+        return {name, ns, misses};
+    }
+    
+public:
+    // Runs the profile on every structure that supports it. Static
+    // structures (SparseTable, BlockRMQ) only take part in read-only runs.
+    static vector<WorkloadResult> benchmark(const WorkloadProfile& p, int seed = 12345) {
+        mt19937 rng(seed);
+        vector<long long> arr(p.n);
+        for (auto& x : arr) x = rng() % 1000;
+        vector<Operation> ops = generateOps(p, rng);
+        bool readOnly = p.readRatio >= 1.0;
+        
+        vector<WorkloadResult> results;
+        if (p.kind == WorkloadProfile::SUM) {
+            {
+                SegmentTree<long long> t(arr);
+                results.push_back(run("SegmentTree", ops,
+                    [&](int l, int r) { return t.query(l, r); },
+                    [&](int i, int v) { t.updateElement(i, v); }));
+            }
+            {
+                IterativeSegmentTree<long long> t(arr);
+                results.push_back(run("IterativeSegmentTree", ops,
+                    [&](int l, int r) { return t.query(l, r); },
+                    [&](int i, int v) { t.updateElement(i, v); }));
+            }
+            {
+                WideSegmentTree<long long> t(arr);
+                results.push_back(run("WideSegmentTree", ops,
+                    [&](int l, int r) { return t.query(l, r); },
+                    [&](int i, int v) { t.updateElement(i, v); }));
+            }
+            {
+                FenwickTree<long long> t(arr);
+                results.push_back(run("FenwickTree", ops,
+                    [&](int l, int r) { return t.rangeSum(l, r); },
+                    [&](int i, int v) { t.updateElement(i, v); }));
+            }
+            {
+                SqrtDecomposition<long long> t(arr);
+                results.push_back(run("SqrtDecomposition", ops,
+                    [&](int l, int r) { return t.rangeSum(l, r); },
+                    [&](int i, int v) { t.updateElement(i, v); }));
+            }
+        } else {
+            {
+                MinSegmentTree<long long> t(arr);
+                results.push_back(run("SegmentTree", ops,
+                    [&](int l, int r) { return t.query(l, r); },
+                    [&](int i, int v) { t.updateElement(i, v); }));
+            }
+            {
+                IterativeSegmentTree<long long, MinOp<long long>> t(arr);
+                results.push_back(run("IterativeSegmentTree", ops,
+                    [&](int l, int r) { return t.query(l, r); },
+                    [&](int i, int v) { t.updateElement(i, v); }));
+            }
+            {
+                WideSegmentTree<long long, MinOp<long long>> t(arr);
+                results.push_back(run("WideSegmentTree", ops,
+                    [&](int l, int r) { return t.query(l, r); },
+                    [&](int i, int v) { t.updateElement(i, v); }));
+            }
+            if (readOnly) {
+                auto noUpdate = [](int, int) {};
+                SparseTable<long long> st(arr);
+                results.push_back(run("SparseTable", ops,
+                    [&](int l, int r) { return st.query(l, r); }, noUpdate));
+                BlockRMQ<long long> rmq(arr);
+                results.push_back(run("BlockRMQ", ops,
+                    [&](int l, int r) { return rmq.query(l, r); }, noUpdate));
+            }
+        }
+        return results;
+    }
+    
+    // Fastest structure for the profile, measured rather than guessed
+    static string recommend(const WorkloadProfile& p) {
+        auto results = benchmark(p);
+        return min_element(results.begin(), results.end(),
+            [](const WorkloadResult& a, const WorkloadResult& b) {
+                return a.nsPerOp < b.nsPerOp;
+            })->structure;
+    }
+    
+    static void report(const WorkloadProfile& p) {
+        static const char* lengthNames[] = {"uniform", "short", "full"};
+        cout << "Workload '" << p.name << "': n = " << p.n << ", ops = " << p.ops
+             << ", reads = " << (int)round(p.readRatio * 100) << "%, "
+             << (p.kind == WorkloadProfile::SUM ? "sum" : "min") << ", "
+             << lengthNames[p.lengths] << " ranges" << endl;
+        
+        auto results = benchmark(p);
+        const WorkloadResult* best = &results[0];
+        for (auto& res : results) {
+            cout << "  " << setw(22) << left << res.structure << right
+                 << fixed << setprecision(1) << setw(9) << res.nsPerOp << " ns/op"
+                 << defaultfloat << "   cache misses: ";
+            if (res.cacheMisses >= 0) cout << res.cacheMisses;
+            else cout << "n/a";
+            cout << endl;
+            if (res.nsPerOp < best->nsPerOp) best = &res;
+        }
+        cout << "  Recommended: " << best->structure << endl;
+    }
+};
+
+void benchmarkWorkloads(int n, int ops) {
+    cout << "Benchmarking range query workloads:" << endl;
+    vector<WorkloadProfile> profiles = {
+        {"read-heavy sums", n, ops, 0.95, WorkloadProfile::SUM, WorkloadProfile::UNIFORM},
+        {"write-heavy sums", n, ops, 0.20, WorkloadProfile::SUM, WorkloadProfile::UNIFORM},
+        {"short sum windows", n, ops, 0.80, WorkloadProfile::SUM, WorkloadProfile::SHORT, 32},
+        {"static minimum", n, ops, 1.00, WorkloadProfile::MIN, WorkloadProfile::UNIFORM},
+        {"dynamic minimum", n, ops, 0.70, WorkloadProfile::MIN, WorkloadProfile::FULL},
+    };
+    for (auto& p : profiles) RangeQueryHarness::report(p);
     cout << endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     ios_base::sync_with_stdio(false);
     cin.tie(NULL);
     
+    // Benchmarks run small so the demo stays instant; pass --full for 2^20
+    // elements, where memory layout rather than cache-resident work dominates
+    bool full = argc > 1 && string(argv[1]) == "--full";
+    int benchSize = full ? 1 << 20 : 1 << 14;
+    
     cout << "Range Query Techniques Test Suite" << endl;
     cout << "=================================" << endl << endl;
     
     testSegmentTree();
+    testIterativeSegmentTrees();
     testLazySegmentTree();
+    testSegmentTreeBeats();
+    testPersistentSegmentTree();
     testFenwickTree();
+    test2DRangeQueries();
     testSparseTable();
+    testWaveletMatrix();
     testSqrtDecomposition();
+    testMoAlgorithm();
+    testBatchQueries();
+    
+    benchmarkSegmentTrees(benchSize, benchSize);
+    benchmarkBatchQueries(benchSize, benchSize);
+    benchmarkWorkloads(benchSize / 4, benchSize / 4);
     
     return 0;
 }
@@ -3,6 +3,123 @@ using namespace std;
 
 const int MOD = 1e9 + 7;
 
+// ============================================================================
+// MODULAR ARITHMETIC
+// ============================================================================
+
+long long power(long long base, long long exp, int mod = MOD) {
+    long long result = 1;
+    base %= mod;
+    
+    while (exp > 0) {
+        if (exp & 1) {
+            result = (result * base) % mod;
+        }
+        base = (base * base) % mod;
+        exp >>= 1;
+    }
+    
+    return result;
+}
+
+long long modInverse(long long a, int mod = MOD) {
+    return power(a, mod - 2, mod);
+}
+
+// Extended GCD
+int extendedGcd(int a, int b, int& x, int& y) {
+    if (b == 0) {
+        x = 1;
+        y = 0;
+        return a;
+    }
+    
+    int x1, y1;
+    int g = extendedGcd(b, a % b, x1, y1);
+    
+    x = y1;
+    y = x1 - (a / b) * y1;
+    
+    return g;
+}
+
+int modInverseExtended(int a, int mod = MOD) {
+    int x, y;
+    int g = extendedGcd(a, mod, x, y);
+    if (g != 1) return -1;
+    return (x % mod + mod) % mod;
+}
+
+// Residue modulo a compile-time odd M < 2^30, stored in Montgomery form
+// (v = x * 2^32 mod M). A product costs three multiplies and no division:
+// t = a * b, q = t * M^-1 (low 32 bits only) and q * M, then a shift and one
+// conditional add. Division/inverse assume M is prime.
+// Mirror of ModInt in 2_NumberTheory/number_theory_algorithms.cpp (the
+// canonical copy), kept verbatim so this file stays standalone.
+template <uint32_t M>
+struct ModInt {
+    static_assert(M % 2 == 1 && M < (1u << 30), "ModInt needs an odd modulus below 2^30");
+    
+    static constexpr uint32_t computeInv() {        // M^-1 mod 2^32 by Newton iteration
+        uint32_t inv = M;
+        for (int i = 0; i < 4; i++) inv *= 2 - M * inv;
+        return inv;
+    }
+    static constexpr uint32_t INV = computeInv();
+    static constexpr uint32_t R2 = -(uint64_t)M % M;    // 2^64 mod M
+    
+    uint32_t v;
+    
+    // t * 2^-32 mod M, for t < M * 2^32
+    static constexpr uint32_t reduce(uint64_t t) {
+        uint32_t m = (uint32_t)t * INV;
+        uint32_t r = (uint32_t)(t >> 32) - (uint32_t)(((uint64_t)m * M) >> 32);
+        return (int32_t)r < 0 ? r + M : r;
+    }
+    
+    constexpr ModInt() : v(0) {}
+    constexpr ModInt(long long x) : v(reduce((uint64_t)((x %= (long long)M) < 0 ? x + M : x) * R2)) {}
+    
+    static constexpr uint32_t mod() { return M; }
+    constexpr uint32_t val() const { return reduce(v); }
+    
+    constexpr ModInt& operator+=(ModInt o) {
+        v += o.v;
+        if (v >= M) v -= M;
+        return *this;
+    }
+    constexpr ModInt& operator-=(ModInt o) {
+        v = v >= o.v ? v - o.v : v + M - o.v;
+        return *this;
+    }
+    constexpr ModInt& operator*=(ModInt o) {
+        v = reduce((uint64_t)v * o.v);
+        return *this;
+    }
+    constexpr ModInt& operator/=(ModInt o) { return *this *= o.inv(); }
+    
+    friend constexpr ModInt operator+(ModInt a, ModInt b) { return a += b; }
+    friend constexpr ModInt operator-(ModInt a, ModInt b) { return a -= b; }
+    friend constexpr ModInt operator*(ModInt a, ModInt b) { return a *= b; }
+    friend constexpr ModInt operator/(ModInt a, ModInt b) { return a /= b; }
+    constexpr ModInt operator-() const { return ModInt() - *this; }
+    friend constexpr bool operator==(ModInt a, ModInt b) { return a.v == b.v; }
+    friend constexpr bool operator!=(ModInt a, ModInt b) { return a.v != b.v; }
+    
+    constexpr ModInt pow(unsigned long long exp) const {
+        ModInt result = 1, base = *this;
+        while (exp > 0) {
+            if (exp & 1) result *= base;
+            base *= base;
+            exp >>= 1;
+        }
+        return result;
+    }
+    constexpr ModInt inv() const { return pow(M - 2); }
+    
+    friend ostream& operator<<(ostream& os, ModInt x) { return os << x.val(); }
+};
+
 // ============================================================================
 // COMBINATORICS
 // ============================================================================
@@ -26,38 +143,70 @@ long long permutation(int n, int r, int mod = MOD) {
     return result;
 }
 
-// Precompute factorials and inverse factorials
-vector<long long> fact, invFact;
-
-void precomputeFactorials(int n, int mod) {
-    fact.resize(n + 1);
-    invFact.resize(n + 1);
+// Factorials, inverse factorials and inverses of 1..n modulo a prime, built
+// in O(n) with a single exponentiation. Queries are const and O(1), so a
+// built table can be shared across threads; grow() must not run concurrently.
+// Canonical copy; 2_NumberTheory/number_theory_algorithms.cpp mirrors it
+// verbatim so that file stays standalone. Change both together.
+class BinomialTable {
+private:
+    int mod;
+    vector<long long> fact, invFact, inv;
+    
+public:
+    BinomialTable(int n, int mod = MOD) : mod(mod), fact{1}, invFact{1}, inv{0} {
+        grow(n);
+    }
     
-    fact[0] = 1;
-    for (int i = 1; i <= n; i++) {
-        fact[i] = (fact[i-1] * i) % mod;
+    int size() const { return fact.size() - 1; }     // largest n covered
+    int modulus() const { return mod; }
+    
+    // Extends the tables to cover n, at least doubling them so repeated growth
+    // is amortized O(1) per entry. n must be below mod, since n! == 0 from
+    // there on; use lucas() for C(n, r) mod a small prime with n >= p.
+    void grow(int n) {
+        assert(n < mod);
+        int oldN = size();
+        if (n <= oldN) return;
+        n = min(max(n, 2 * oldN), mod - 1);
+        fact.resize(n + 1);
+        invFact.resize(n + 1);
+        inv.resize(n + 1);
+        
+        for (int i = oldN + 1; i <= n; i++) fact[i] = fact[i - 1] * i % mod;
+        invFact[n] = power(fact[n], mod - 2, mod);
+        for (int i = n; i > oldN + 1; i--) invFact[i - 1] = invFact[i] * i % mod;
+        for (int i = oldN + 1; i <= n; i++) inv[i] = invFact[i] * fact[i - 1] % mod;
+    }
+    
+    long long factorial(int n) const { return n >= 0 && n <= size() ? fact[n] : 0; }
+    long long inverseFactorial(int n) const { return n >= 0 && n <= size() ? invFact[n] : 0; }
+    long long inverse(int n) const { return n >= 1 && n <= size() ? inv[n] : 0; }
+    
+    // C(n, r); 0 when r is out of [0, n] or n is beyond the table (grow() first)
+    long long nCr(int n, int r) const {
+        if (r < 0 || r > n || n > size()) return 0;
+        return fact[n] * invFact[r] % mod * invFact[n - r] % mod;
     }
     
-    invFact[n] = modInverse(fact[n], mod);
-    for (int i = n - 1; i >= 0; i--) {
-        invFact[i] = (invFact[i+1] * (i + 1)) % mod;
+    // P(n, r) = n! / (n-r)!; 0 when out of range as for nCr
+    long long nPr(int n, int r) const {
+        if (r < 0 || r > n || n > size()) return 0;
+        return fact[n] * invFact[n - r] % mod;
     }
-}
-
-// Combination: C(n, r) = n! / (r! × (n-r)!)
-long long nCr(int n, int r, int mod = MOD) {
-    if (r > n || r < 0) return 0;
-    return (fact[n] * invFact[r] % mod) * invFact[n-r] % mod;
-}
+    
+    // Catalan(n) = (2n)! / ((n+1)! n!); 0 when 2n is beyond the table
+    long long catalan(int n) const {
+        if (n < 0 || 2LL * n > size()) return 0;
+        if (n == 0) return 1 % mod;         // invFact[n + 1] may not exist yet
+        return fact[2 * n] * invFact[n + 1] % mod * invFact[n] % mod;
+    }
+};
 
 // ============================================================================
 // CATALAN NUMBERS
 // ============================================================================
 
-long long catalan(int n, int mod = MOD) {
-    return nCr(2 * n, n, mod) * modInverse(n + 1, mod) % mod;
-}
-
 // Direct calculation
 long long catalanDirect(int n, int mod = MOD) {
     long long c = 1;
@@ -120,53 +269,6 @@ long long derangement(int n, int mod = MOD) {
     return prev1;
 }
 
-// ============================================================================
-// MODULAR ARITHMETIC
-// ============================================================================
-
-long long modInverse(long long a, int mod = MOD) {
-    return power(a, mod - 2, mod);
-}
-
-long long power(long long base, long long exp, int mod = MOD) {
-    long long result = 1;
-    base %= mod;
-    
-    while (exp > 0) {
-        if (exp & 1) {
-            result = (result * base) % mod;
-        }
-        base = (base * base) % mod;
-        exp >>= 1;
-    }
-    
-    return result;
-}
-
-// Extended GCD
-int extendedGcd(int a, int b, int& x, int& y) {
-    if (b == 0) {
-        x = 1;
-        y = 0;
-        return a;
-    }
-    
-    int x1, y1;
-    int g = extendedGcd(b, a % b, x1, y1);
-    
-    x = y1;
-    y = x1 - (a / b) * y1;
-    
-    return g;
-}
-
-int modInverseExtended(int a, int mod = MOD) {
-    int x, y;
-    int g = extendedGcd(a, mod, x, y);
-    if (g != 1) return -1;
-    return (x % mod + mod) % mod;
-}
-
 // ============================================================================
 // GCD AND LCM
 // ============================================================================
@@ -267,8 +369,9 @@ long long expectedValue(vector<pair<int, int>>& outcomes, int mod = MOD) {
     return result;
 }
 
-long long binomialProbability(int n, int k, int p, int mod = MOD) {
-    long long C = nCr(n, k, mod);
+long long binomialProbability(const BinomialTable& binom, int n, int k, int p) {
+    int mod = binom.modulus();
+    long long C = binom.nCr(n, k);
     long long prob_k = power(p, k, mod);
     long long prob_n_minus_k = power(mod + 1 - p, n - k, mod);
     return (C * prob_k % mod) * prob_n_minus_k % mod;
@@ -282,12 +385,19 @@ long long geometricExpected(int p, int mod = MOD) {
 // LUCAS THEOREM
 // ============================================================================
 
-long long lucas(int n, int r, int p) {
-    if (r > n) return 0;
-    if (r == 0 || r == n) return 1;
-    
-    return (lucas(n / p, r / p, p) * 
-            nCr(n % p, r % p, p)) % p;
+// C(n, r) mod a small prime p, one base-p digit at a time. binom must be
+// built for p and cover p - 1, e.g. BinomialTable(p - 1, p), and can be
+// reused across calls.
+long long lucas(long long n, long long r, const BinomialTable& binom) {
+    int p = binom.modulus();
+    assert(binom.size() >= p - 1);
+    long long result = 1;
+    while (r > 0 && result > 0) {
+        result = result * binom.nCr(n % p, r % p) % p;
+        n /= p;
+        r /= p;
+    }
+    return result;
 }
 
 // ============================================================================
@@ -317,6 +427,216 @@ long long inclusionExclusion(vector<int>& sets, int n, int mod = MOD) {
     return result;
 }
 
+// ============================================================================
+// POLYNOMIAL ARITHMETIC (NTT)
+// ============================================================================
+
+// Number-theoretic transform over Z_M for an NTT-friendly prime M = c * 2^k + 1
+// with primitive root G. Forward is decimation-in-frequency (natural order in,
+// bit-reversed out) and inverse is decimation-in-time (bit-reversed in, natural
+// out), so no bit-reversal pass is needed between them. Twiddles for each
+// level are stored contiguously and grown on demand.
+template <uint32_t M, uint32_t G = 3>
+class NTT {
+public:
+    using Mint = ModInt<M>;
+    
+private:
+    // roots[k + j] = w^j for w a primitive 2k-th root, k a power of two
+    vector<Mint> roots{0, 1}, iroots{0, 1};
+    vector<Mint> invs{0, 1};     // invs[i] = 1 / i
+    
+    void prepareRoots(int n) {
+        while ((int)roots.size() < n) {
+            int k = roots.size();
+            assert((M - 1) % (2 * k) == 0);
+            Mint z = Mint(G).pow((M - 1) / (2 * k)), iz = z.inv();
+            roots.resize(2 * k);
+            iroots.resize(2 * k);
+            for (int j = k; j < 2 * k; j++) {
+                roots[j] = j & 1 ? roots[j / 2] * z : roots[j / 2];
+                iroots[j] = j & 1 ? iroots[j / 2] * iz : iroots[j / 2];
+            }
+        }
+    }
+    
+    void prepareInverses(int n) {
+        for (int i = invs.size(); i <= n; i++) invs.push_back(-Mint(M / i) * invs[M % i]);
+    }
+    
+public:
+    // In-place forward transform; a.size() must be a power of two. Layers are
+    // fused in pairs into radix-4 butterflies (half the passes over memory),
+    // with one radix-2 layer at the end when log2(n) is odd.
+    void transform(vector<Mint>& a) {
+        int n = a.size();
+        prepareRoots(max(n, 4));
+        const Mint imag = roots[3];     // primitive 4th root
+        int len = n / 2;
+        for (; len >= 2; len >>= 2) {
+            int h = len / 2;
+            const Mint* __restrict tw1 = roots.data() + 2 * h;
+            const Mint* __restrict tw2 = roots.data() + h;
+            for (int i = 0; i < n; i += 4 * h) {
+                // Disjoint quarters of the block, so the j loop vectorizes
+                Mint* __restrict q0 = a.data() + i;
+                Mint* __restrict q1 = q0 + h;
+                Mint* __restrict q2 = q1 + h;
+                Mint* __restrict q3 = q2 + h;
+                for (int j = 0; j < h; j++) {
+                    Mint s02 = q0[j] + q2[j], d02 = q0[j] - q2[j];
+                    Mint s13 = q1[j] + q3[j], d13 = (q1[j] - q3[j]) * imag;
+                    q0[j] = s02 + s13;
+                    q1[j] = (s02 - s13) * tw2[j];
+                    q2[j] = (d02 + d13) * tw1[j];
+                    q3[j] = (d02 - d13) * (tw1[j] * tw2[j]);
+                }
+            }
+        }
+        if (len == 1) {
+            for (int i = 0; i < n; i += 2) {
+                Mint u = a[i], v = a[i + 1];
+                a[i] = u + v;
+                a[i + 1] = u - v;
+            }
+        }
+    }
+    
+    // Exact inverse of transform, including the 1/n scaling
+    void inverseTransform(vector<Mint>& a) {
+        int n = a.size();
+        prepareRoots(max(n, 4));
+        const Mint imagInv = iroots[3];
+        int h = 1;
+        if (__builtin_ctz(n) % 2 == 1) {
+            for (int i = 0; i < n; i += 2) {
+                Mint u = a[i], v = a[i + 1];
+                a[i] = u + v;
+                a[i + 1] = u - v;
+            }
+            h = 2;
+        }
+        for (; 2 * h < n; h <<= 2) {
+            const Mint* __restrict tw1 = iroots.data() + 2 * h;
+            const Mint* __restrict tw2 = iroots.data() + h;
+            for (int i = 0; i < n; i += 4 * h) {
+                Mint* __restrict q0 = a.data() + i;
+                Mint* __restrict q1 = q0 + h;
+                Mint* __restrict q2 = q1 + h;
+                Mint* __restrict q3 = q2 + h;
+                for (int j = 0; j < h; j++) {
+                    Mint p1 = q1[j] * tw2[j], p2 = q2[j] * tw1[j], p3 = q3[j] * (tw1[j] * tw2[j]);
+                    Mint s01 = q0[j] + p1, d01 = q0[j] - p1;
+                    Mint s23 = p2 + p3, d23 = (p2 - p3) * imagInv;
+                    q0[j] = s01 + s23;
+                    q1[j] = d01 + d23;
+                    q2[j] = s01 - s23;
+                    q3[j] = d01 - d23;
+                }
+            }
+        }
+        Mint scale = Mint(n).inv();
+        for (Mint& x : a) x *= scale;
+    }
+    
+    vector<Mint> multiply(vector<Mint> a, vector<Mint> b) {
+        if (a.empty() || b.empty()) return {};
+        int resultSize = a.size() + b.size() - 1;
+        if (min(a.size(), b.size()) <= 32) {      // schoolbook wins for tiny inputs
+            vector<Mint> c(resultSize);
+            for (size_t i = 0; i < a.size(); i++) {
+                for (size_t j = 0; j < b.size(); j++) c[i + j] += a[i] * b[j];
+            }
+            return c;
+        }
+        int n = 1;
+        while (n < resultSize) n <<= 1;
+        a.resize(n);
+        b.resize(n);
+        transform(a);
+        transform(b);
+        for (int i = 0; i < n; i++) a[i] *= b[i];
+        inverseTransform(a);
+        a.resize(resultSize);
+        return a;
+    }
+    
+    // First n coefficients of 1 / f by Newton iteration g <- g (2 - f g); f[0] != 0
+    vector<Mint> inverseSeries(const vector<Mint>& f, int n) {
+        vector<Mint> g = {f[0].inv()};
+        for (int k = 1; k < n; k *= 2) {
+            int m = 2 * k;
+            vector<Mint> fa(f.begin(), f.begin() + min<size_t>(f.size(), m)), ga = g;
+            fa.resize(2 * m);
+            ga.resize(2 * m);
+            transform(fa);
+            transform(ga);
+            for (int i = 0; i < 2 * m; i++) fa[i] = ga[i] * (Mint(2) - fa[i] * ga[i]);
+            inverseTransform(fa);
+            fa.resize(m);
+            g = fa;
+        }
+        g.resize(n);
+        return g;
+    }
+    
+    // First n coefficients of log f = integral(f' / f); f[0] == 1
+    vector<Mint> logSeries(const vector<Mint>& f, int n) {
+        vector<Mint> derivative(max(1, n - 1));
+        for (int i = 1; i < min<int>(f.size(), n); i++) derivative[i - 1] = f[i] * i;
+        vector<Mint> quotient = multiply(derivative, inverseSeries(f, n));
+        prepareInverses(n);
+        vector<Mint> result(n);
+        for (int i = 1; i < n; i++) result[i] = quotient[i - 1] * invs[i];
+        return result;
+    }
+    
+    // First n coefficients of exp f by Newton iteration g <- g (1 - log g + f); f[0] == 0
+    vector<Mint> expSeries(const vector<Mint>& f, int n) {
+        vector<Mint> g = {1};
+        for (int k = 1; k < n; k *= 2) {
+            int m = 2 * k;
+            vector<Mint> t = logSeries(g, m);
+            for (int i = 0; i < m; i++) t[i] = (i < (int)f.size() ? f[i] : Mint(0)) - t[i];
+            t[0] += 1;
+            g = multiply(g, t);
+            g.resize(m);
+        }
+        g.resize(n);
+        return g;
+    }
+};
+
+// Convolution modulo any mod < 2^31: three NTT-prime products recombined by
+// Garner's CRT, exact while n * mod^2 stays below their product (~2^86)
+vector<long long> convolutionMod(const vector<long long>& a, const vector<long long>& b, long long mod) {
+    if (a.empty() || b.empty()) return {};
+    const uint32_t M1 = 998244353, M2 = 167772161, M3 = 469762049;
+    
+    auto convolveIn = [&](auto ntt) {
+        using Mint = typename decltype(ntt)::Mint;
+        vector<Mint> fa(a.begin(), a.end()), fb(b.begin(), b.end());
+        return ntt.multiply(fa, fb);
+    };
+    auto c1 = convolveIn(NTT<M1>());
+    auto c2 = convolveIn(NTT<M2>());
+    auto c3 = convolveIn(NTT<M3>());
+    
+    const ModInt<M2> inv1 = ModInt<M2>(M1).inv();
+    const ModInt<M3> inv12 = (ModInt<M3>(M1) * ModInt<M3>(M2)).inv();
+    const long long m12 = (long long)M1 * M2 % mod;
+    
+    vector<long long> c(c1.size());
+    for (size_t i = 0; i < c.size(); i++) {
+        // x = t1 + M1 * t2 + M1 * M2 * t3 with each t_i reduced mod M_i
+        long long t1 = c1[i].val();
+        long long t2 = ((ModInt<M2>(c2[i].val()) - ModInt<M2>(t1)) * inv1).val();
+        long long t3 = ((ModInt<M3>(c3[i].val()) - ModInt<M3>(t1) - ModInt<M3>(M1) * ModInt<M3>(t2)) * inv12).val();
+        c[i] = (t1 + (__int128)M1 * t2 + (__int128)m12 * t3) % mod;
+    }
+    return c;
+}
+
 // ============================================================================
 // TESTING FUNCTIONS
 // ============================================================================
@@ -325,11 +645,13 @@ void testCombinatorics() {
     cout << "Testing Combinatorics:" << endl;
     
     int n = 10, r = 3;
-    precomputeFactorials(n, MOD);
+    BinomialTable binom(n, MOD);
     
-    cout << "C(10,3): " << nCr(10, 3, MOD) << endl;
-    cout << "P(10,3): " << permutation(10, 3, MOD) << endl;
-    cout << "Catalan(5): " << catalan(5, MOD) << endl;
+    cout << "C(10,3): " << binom.nCr(n, r) << endl;
+    cout << "P(10,3): " << binom.nPr(n, r) << endl;
+    cout << "Catalan(5): " << binom.catalan(5) << endl;
+    BinomialTable mod13(12, 13);
+    cout << "Lucas C(1000, 300) mod 13: " << lucas(1000, 300, mod13) << endl;
     cout << "Derangement(5): " << derangement(5, MOD) << endl;
     
     cout << endl;
@@ -368,6 +690,98 @@ void testProbability() {
     cout << endl;
 }
 
+void testPolynomials() {
+    cout << "Testing Polynomial Arithmetic (NTT):" << endl;
+    
+    using Mint = ModInt<998244353>;
+    NTT<998244353> ntt;
+    
+    // (1 + x)^2 * (1 + x)^3 = (1 + x)^5
+    vector<Mint> product = ntt.multiply({1, 2, 1}, {1, 3, 3, 1});
+    cout << "(1+x)^2 * (1+x)^3: ";
+    for (Mint c : product) cout << c << " ";
+    cout << endl;
+    
+    // Partition numbers: 1 / prod(1 - x^k), the Euler function being sparse
+    // (pentagonal number theorem)
+    int n = 101;
+    vector<Mint> euler(n);
+    for (int k = 0; k * (3 * k - 1) / 2 < n; k++) {
+        Mint sign = k % 2 ? -1 : 1;
+        euler[k * (3 * k - 1) / 2] += sign;
+        if (k > 0 && k * (3 * k + 1) / 2 < n) euler[k * (3 * k + 1) / 2] += sign;
+    }
+    vector<Mint> partitions = ntt.inverseSeries(euler, n);
+    cout << "p(10), p(100): " << partitions[10] << ", " << partitions[100] << endl;
+    
+    // exp(log f) == f
+    vector<Mint> f = {1, 5, 7, 2, 9};
+    vector<Mint> roundTrip = ntt.expSeries(ntt.logSeries(f, 5), 5);
+    cout << "exp(log f) == f: " << (roundTrip == f) << endl;
+    
+    // Arbitrary modulus through three-prime CRT
+    vector<long long> c = convolutionMod({MOD - 1, MOD - 1}, {MOD - 1, MOD - 1}, MOD);
+    cout << "(-1 - x)^2 mod 1e9+7: " << c[0] << " " << c[1] << " " << c[2] << endl;
+    
+    // Inputs longer than 32 take the NTT path instead of schoolbook
+    mt19937 rng(7);
+    vector<Mint> pa(100), pb(77);
+    for (Mint& x : pa) x = rng();
+    for (Mint& x : pb) x = rng();
+    vector<Mint> expected(pa.size() + pb.size() - 1);
+    for (size_t i = 0; i < pa.size(); i++) {
+        for (size_t j = 0; j < pb.size(); j++) expected[i + j] += pa[i] * pb[j];
+    }
+    cout << "100 x 77 NTT product == schoolbook: " << (ntt.multiply(pa, pb) == expected) << endl;
+    
+    vector<long long> la(70), lb(45);
+    for (long long& x : la) x = rng() % MOD;
+    for (long long& x : lb) x = rng() % MOD;
+    vector<long long> naive(la.size() + lb.size() - 1);
+    for (size_t i = 0; i < la.size(); i++) {
+        for (size_t j = 0; j < lb.size(); j++) naive[i + j] = (naive[i + j] + la[i] * lb[j]) % MOD;
+    }
+    cout << "70 x 45 convolutionMod == schoolbook: " << (convolutionMod(la, lb, MOD) == naive) << endl;
+    
+    cout << endl;
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+void benchmarkNTT() {
+    cout << "Benchmarking NTT Multiply:" << endl;
+    
+    mt19937 rng(42);
+    NTT<998244353> ntt;
+    using Mint = NTT<998244353>::Mint;
+    
+    for (int logN = 20; logN <= 23; logN++) {
+        int half = 1 << (logN - 1);
+        vector<Mint> a(half), b(half);
+        for (int i = 0; i < half; i++) a[i] = rng(), b[i] = rng();
+        
+        auto start = chrono::steady_clock::now();
+        vector<Mint> c = ntt.multiply(a, b);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "  length 2^" << logN << ": " << fixed << setprecision(1) << ms << " ms" << defaultfloat << endl;
+    }
+    
+    for (int logN = 20; logN <= 21; logN++) {
+        int half = 1 << (logN - 1);
+        vector<long long> a(half), b(half);
+        for (int i = 0; i < half; i++) a[i] = rng() % MOD, b[i] = rng() % MOD;
+        
+        auto start = chrono::steady_clock::now();
+        vector<long long> c = convolutionMod(a, b, MOD);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "  length 2^" << logN << " mod 1e9+7 (3-prime CRT): " << fixed << setprecision(1) << ms << " ms" << defaultfloat << endl;
+    }
+    
+    cout << endl;
+}
+
 int main() {
     ios_base::sync_with_stdio(false);
     cin.tie(NULL);
@@ -379,6 +793,9 @@ int main() {
     testStirling();
     testMatrixOperations();
     testProbability();
+    testPolynomials();
+    
+    benchmarkNTT();
     
     return 0;
 }